@@ -0,0 +1,219 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* strtol EXIT_* */
+#include <stdio.h>  /* printf */
+#include <string.h>	/* strcmp strlen */
+
+/** Writes a synthetic EVNEW text export of misns and crons on stdout, in the
+ same columns that Penguin reads, for timing it at sizes that we don't have
+ real data for. The same options and seed always give the same file.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+/* the fields are read into 128 bytes */
+static const size_t expression_size = 128;
+/* bits after the others that are cleared by crons, like b6666 */
+static const int reset_bits_size = 16;
+
+/* options */
+static int misns_size  = 10000;
+static int crons_size  = 1000;
+static int bits_size   = 0;	/* default is half the misns */
+static int terms       = 3;	/* bits per expression, at most */
+static int depth       = 1;	/* parenthesis in a test */
+static int reset       = 10;	/* percent of crons that reset a bit */
+static unsigned long seed = 1;
+
+/* private prototypes */
+
+static unsigned long random_next(void);
+static int random_int(const int n);
+static void test(char *const expr, const int level);
+static void effect(char *const expr, const int is_misn);
+static void append(char *const expr, const char *const format, const int a);
+static void print_misn(const int id);
+static void print_cron(const int id);
+static int option(const char *const arg, int *const pi);
+static void usage(const char *const programme);
+
+/** Entry point.
+ @return	Either EXIT_SUCCESS or EXIT_FAILURE. */
+int main(int argc, char **argv) {
+	int i, s;
+
+	for(i = 1; i < argc; i++) {
+		if(i + 1 >= argc) { usage(argv[0]); return EXIT_FAILURE; }
+		if(!strcmp(argv[i], "-m")) {
+			if(!option(argv[++i], &misns_size)) return EXIT_FAILURE;
+		} else if(!strcmp(argv[i], "-c")) {
+			if(!option(argv[++i], &crons_size)) return EXIT_FAILURE;
+		} else if(!strcmp(argv[i], "-b")) {
+			if(!option(argv[++i], &bits_size)) return EXIT_FAILURE;
+		} else if(!strcmp(argv[i], "-e")) {
+			if(!option(argv[++i], &terms)) return EXIT_FAILURE;
+		} else if(!strcmp(argv[i], "-d")) {
+			if(!option(argv[++i], &depth)) return EXIT_FAILURE;
+		} else if(!strcmp(argv[i], "-r")) {
+			if(!option(argv[++i], &reset) || reset > 100) return EXIT_FAILURE;
+		} else if(!strcmp(argv[i], "-s")) {
+			if(!option(argv[++i], &s)) return EXIT_FAILURE;
+			seed = (unsigned long)s;
+		} else {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if(!bits_size) bits_size = misns_size / 2 + 1;
+	/* xorshift is stuck at zero */
+	if(!(seed &= 0xffffffffUL)) seed = 1;
+
+	/* the misns and crons are mixed like in the export */
+	for(i = 0; i < misns_size + crons_size; i++) {
+		if(i < misns_size) print_misn(128 + i);
+		if(i < crons_size) print_cron(128 + i);
+	}
+	if(ferror(stdout)) {
+		perror("stdout");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/** Xorshift; rand() is different on every platform.
+ @return	[0, 2^32). */
+static unsigned long random_next(void) {
+	seed ^= (seed << 13) & 0xffffffffUL;
+	seed ^= seed >> 17;
+	seed ^= (seed << 5) & 0xffffffffUL;
+	return seed;
+}
+
+/** @return	[0, n). */
+static int random_int(const int n) {
+	return n > 0 ? (int)(random_next() % (unsigned long)n) : 0;
+}
+
+/** Appends a test of up to terms bits to expr; some terms are negative bits
+ in parenthesis, up to depth, like "b3 & (!b9 | (!b5 | !b2))," which is what
+ Penguin understands. Each term, with its operator and any parenthesis, is
+ made on its own and only goes in if all of it fits, so a test that's cut
+ short is still well-formed. */
+static void test(char *const expr, const int level) {
+	char term[128 + 8], group[128]; /* expression_size */
+	int i, n = 1 + random_int(terms);
+
+	for(i = 0; i < n; i++) {
+		term[0] = '\0';
+		if(i) append(term, level ? " | " : " & ", 0);
+		if(!level && reset && random_int(8) == 0) {
+			append(term, "!b%d", bits_size + random_int(reset_bits_size));
+		} else if(level < depth && random_int(4) == 0) {
+			group[0] = '\0';
+			test(group, level + 1);
+			if(!*group) break; /* nothing in it fit */
+			strcat(term, "(");
+			strcat(term, group);
+			strcat(term, ")");
+		} else if(level) {
+			append(term, "!b%d", random_int(bits_size));
+		} else {
+			append(term, "b%d", random_int(bits_size));
+		}
+		if(strlen(expr) + strlen(term) >= expression_size) break;
+		strcat(expr, term);
+	}
+}
+
+/** Appends up to terms effects to expr: bits set and cleared, and if is_misn,
+ some misns started or aborted; crons can't. */
+static void effect(char *const expr, const int is_misn) {
+	int i, n = random_int(terms + 1), r;
+
+	for(i = 0; i < n; i++) {
+		if(i) append(expr, " ", 0);
+		r = random_int(is_misn ? 20 : 17);
+		if(r < 1)       append(expr, "b%d", bits_size + random_int(reset_bits_size));
+		else if(r < 12) append(expr, "b%d", random_int(bits_size));
+		else if(r < 17) append(expr, "!b%d", random_int(bits_size));
+		else if(r < 19) append(expr, "s%d", 128 + random_int(misns_size));
+		else            append(expr, "a%d", 128 + random_int(misns_size));
+	}
+}
+
+/** Appends format, which has at most one %d, to expr, if it fits. */
+static void append(char *const expr, const char *const format, const int a) {
+	char term[32];
+	size_t len = strlen(expr);
+
+	sprintf(term, format, a);
+	if(len + strlen(term) >= expression_size) return;
+	strcpy(expr + len, term);
+}
+
+/** Prints a misn record. */
+static void print_misn(const int id) {
+	char expr[7][128];
+	int i;
+
+	for(i = 0; i < 7; i++) expr[i][0] = '\0';
+	/* some misns are available from the start */
+	if(random_int(8)) test(expr[0], 0);
+	for(i = 1; i < 7; i++) effect(expr[i], -1);
+	printf("\"misn\"\t%d\t\"Misn %d\"", id, id);
+	for(i = 0; i < 36; i++) {
+		if(i == 11) printf("\t0x%04X", random_int(0x10000));
+		else printf("\t%d", random_int(300) - 1);
+	}
+	for(i = 0; i < 7; i++) printf("\t\"%s\"", expr[i]);
+	printf("\t0x0000\t%d\t\"\"\t\"Refuse\"\t1\t0\t0x%04X\t0x0000\t\"EOR\"\n", random_int(3), random_int(0x10000));
+}
+
+/** Prints a cron record; reset percent of them are enabled by a bit and clear
+ it, so Penguin will cull the bit. */
+static void print_cron(const int id) {
+	char expr[3][128];
+	int i, b;
+
+	for(i = 0; i < 3; i++) expr[i][0] = '\0';
+	if(random_int(100) < reset) {
+		b = bits_size + random_int(reset_bits_size);
+		append(expr[0], "b%d", b);
+		append(expr[1 + random_int(2)], "!b%d", b);
+	} else {
+		test(expr[0], 0);
+		effect(expr[1], 0);
+		effect(expr[2], 0);
+	}
+	printf("\"cron\"\t%d\t\"Cron %d\"", id, id);
+	for(i = 0; i < 10; i++) printf("\t%d", random_int(30) - 1);
+	for(i = 0; i < 3; i++) printf("\t\"%s\"", expr[i]);
+	printf("\t0x0000\t0x0000");
+	for(i = 0; i < 10; i++) printf("\t%d", random_int(100) - 1);
+	printf("\t\"EOR\"\n");
+}
+
+/** Reads a non-negative integer.
+ @return	Success. */
+static int option(const char *const arg, int *const pi) {
+	char *end;
+	long l = strtol(arg, &end, 0);
+
+	if(*end || l < 0 || l > 1000000) {
+		fprintf(stderr, "%s: expected a number in [0, 1000000].\n", arg);
+		return 0;
+	}
+	*pi = (int)l;
+	return -1;
+}
+
+static void usage(const char *const programme) {
+	fprintf(stderr, "Usage: %s [-m misns] [-c crons] [-b bits] [-e terms] [-d depth]\n       [-r reset] [-s seed] > bench.tsv\n\n", programme);
+	fprintf(stderr, "Writes misns and crons like an EVNEW text export. -b is how many different\n");
+	fprintf(stderr, "bits there are (half the misns,) -e is the most bits in an expression (%d,)\n", terms);
+	fprintf(stderr, "-d is how deep the parenthesis go in a test (%d,) -r is the percent of crons\n", depth);
+	fprintf(stderr, "that are enabled by a bit and clear it (%d,) and -s is the seed (%lu.)\n\n", reset, seed);
+}
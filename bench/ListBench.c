@@ -0,0 +1,281 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* malloc realloc free qsort EXIT_* */
+#include <stdio.h>  /* printf */
+#include <string.h>	/* memcpy memset */
+#include <time.h>	/* clock */
+#include "../src/List.h"
+
+/** Times the operations of List on their own, without Penguin's input and
+ output, against a plain array that does the same thing with a loop, for each
+ element width and list size. The numbers are nanoseconds per element, over
+ enough repetitions to be about a million elements.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+static const size_t widths[] = { 4, 16, 64, 256 };
+static const int sizes[] = { 100, 10000, 1000000 };
+static const size_t bytes_limit = 1 << 26; /* skip bigger lists */
+static const long elements = 1000000; /* per measurement, about */
+
+enum Operation { O_ADD, O_ITERATE, O_FOR_EACH, O_SHORT_CIRCUIT, O_REMOVE_IF,
+	O_SORT, O_SIZE };
+static const char *const operation_name[] = { "ListAdd", "ListIterate",
+	"ListForEach", "ListShortCircuit", "ListRemoveIf", "ListSort" };
+
+/* the plain array that List is compared with; it doubles */
+struct Array {
+	char *data;
+	size_t width, size, capacity;
+};
+
+static unsigned long seed = 1;
+static long sum; /* so the loops are not optimised away */
+
+/* private prototypes */
+
+static double time_list(const enum Operation o, const size_t width, const int size, const int reps, const char *const keys);
+static double time_array(const enum Operation o, const size_t width, const int size, const int reps, const char *const keys);
+static int fill_list(struct List *const l, const size_t width, const int size, const char *const keys);
+static int fill_array(struct Array *const a, const int size, const char *const keys);
+static int array_add(struct Array *const a, const void *const e);
+static void add_key(void *const e);
+static int is_any(void *const e, void *const param);
+static int is_odd(void *const e, void *const param);
+static int compare(const void *a, const void *b);
+static unsigned long random_next(void);
+
+/** Entry point.
+ @return	Either EXIT_SUCCESS or EXIT_FAILURE. */
+int main(void) {
+	const int widths_size = sizeof widths / sizeof *widths;
+	const int sizes_size = sizeof sizes / sizeof *sizes;
+	char *keys;
+	double list, array;
+	int w, s, o, i, reps, key;
+
+	printf("%-16s %5s %8s %10s %10s %6s\n", "operation", "width", "size", "List ns", "array ns", "ratio");
+	for(o = 0; o < O_SIZE; o++) {
+		for(w = 0; w < widths_size; w++) {
+			for(s = 0; s < sizes_size; s++) {
+				if(widths[w] * sizes[s] > bytes_limit) continue;
+				/* the same elements for List and the array */
+				if(!(keys = malloc(widths[w] * sizes[s]))) {
+					perror("keys");
+					return EXIT_FAILURE;
+				}
+				memset(keys, 0, widths[w] * sizes[s]);
+				for(i = 0; i < sizes[s]; i++) {
+					key = (int)(random_next() & 0xffffff);
+					memcpy(keys + widths[w] * i, &key, sizeof key);
+				}
+				reps = (int)(elements / sizes[s]);
+				if(reps < 1) reps = 1;
+				list  = time_list(o, widths[w], sizes[s], reps, keys);
+				array = time_array(o, widths[w], sizes[s], reps, keys);
+				free(keys);
+				if(list < 0.0 || array < 0.0) {
+					fprintf(stderr, "%s: out of memory.\n", operation_name[o]);
+					return EXIT_FAILURE;
+				}
+				printf("%-16s %5lu %8d %10.2f %10.2f %6.2f\n", operation_name[o],
+					(unsigned long)widths[w], sizes[s], list, array,
+					array > 0.0 ? list / array : 0.0);
+			}
+		}
+	}
+	fflush(stdout);
+	fprintf(stderr, "Checksum %ld.\n", sum);
+
+	return EXIT_SUCCESS;
+}
+
+/** Times reps of operation o on a List of size elements from keys.
+ @return	Nanoseconds per element, or -1 if the memory ran out. */
+static double time_list(const enum Operation o, const size_t width, const int size, const int reps, const char *const keys) {
+	struct List *l;
+	clock_t t = 0, t0;
+	void *e;
+	int r, i, is_ok = -1;
+
+	if(!(l = List(width))) return -1.0;
+	for(r = 0; is_ok && r < reps; r++) {
+		switch(o) {
+			case O_ADD:
+				/* a new list every time, so it grows from nothing */
+				List_(&l);
+				t0 = clock();
+				if(!(l = List(width))) return -1.0;
+				for(i = 0; i < size; i++) if(!ListAdd(l, keys + width * i)) is_ok = 0;
+				t += clock() - t0;
+				break;
+			case O_ITERATE:
+				if(!r && !fill_list(l, width, size, keys)) is_ok = 0;
+				t0 = clock();
+				while((e = ListIterate(l))) sum += *(int *)e;
+				t += clock() - t0;
+				break;
+			case O_FOR_EACH:
+				if(!r && !fill_list(l, width, size, keys)) is_ok = 0;
+				t0 = clock();
+				ListForEach(l, &add_key);
+				t += clock() - t0;
+				break;
+			case O_SHORT_CIRCUIT:
+				if(!r && !fill_list(l, width, size, keys)) is_ok = 0;
+				t0 = clock();
+				sum += ListShortCircuit(l, &is_any, 0);
+				t += clock() - t0;
+				break;
+			case O_REMOVE_IF:
+				if(!fill_list(l, width, size, keys)) is_ok = 0;
+				t0 = clock();
+				sum += ListRemoveIf(l, &is_odd, 0);
+				t += clock() - t0;
+				break;
+			case O_SORT:
+				/* adding forgets that it was sorted */
+				if(!fill_list(l, width, size, keys)) is_ok = 0;
+				t0 = clock();
+				ListSort(l, &compare);
+				t += clock() - t0;
+				break;
+			case O_SIZE:
+				break;
+		}
+	}
+	List_(&l);
+	if(!is_ok) return -1.0;
+	return 1e9 * t / CLOCKS_PER_SEC / ((double)reps * size);
+}
+
+/** Does the same as @see{time_list} with a plain array and loops.
+ @return	Nanoseconds per element, or -1 if the memory ran out. */
+static double time_array(const enum Operation o, const size_t width, const int size, const int reps, const char *const keys) {
+	struct Array a = { 0, 0, 0, 0 };
+	clock_t t = 0, t0;
+	char *e, *f, *end;
+	int r, i, is_ok = -1;
+
+	a.width = width;
+	for(r = 0; is_ok && r < reps; r++) {
+		switch(o) {
+			case O_ADD:
+				free(a.data);
+				a.data = 0;
+				a.size = a.capacity = 0;
+				t0 = clock();
+				for(i = 0; i < size; i++) if(!array_add(&a, keys + width * i)) is_ok = 0;
+				t += clock() - t0;
+				break;
+			case O_ITERATE:
+			case O_FOR_EACH:
+				if(!r && !fill_array(&a, size, keys)) is_ok = 0;
+				t0 = clock();
+				for(e = a.data, end = a.data + a.size * width; e < end; e += width) sum += *(int *)e;
+				t += clock() - t0;
+				break;
+			case O_SHORT_CIRCUIT:
+				if(!r && !fill_array(&a, size, keys)) is_ok = 0;
+				t0 = clock();
+				for(e = a.data, end = a.data + a.size * width; e < end && is_any(e, 0); e += width);
+				sum += e == end;
+				t += clock() - t0;
+				break;
+			case O_REMOVE_IF:
+				if(!fill_array(&a, size, keys)) is_ok = 0;
+				t0 = clock();
+				for(e = f = a.data, end = a.data + a.size * width; e < end; e += width) {
+					if(is_odd(e, 0)) continue;
+					if(e != f) memcpy(f, e, width);
+					f += width;
+				}
+				sum += (long)(a.size - (f - a.data) / width);
+				a.size = (f - a.data) / width;
+				t += clock() - t0;
+				break;
+			case O_SORT:
+				if(!fill_array(&a, size, keys)) is_ok = 0;
+				t0 = clock();
+				qsort(a.data, a.size, width, &compare);
+				t += clock() - t0;
+				break;
+			case O_SIZE:
+				break;
+		}
+	}
+	free(a.data);
+	if(!is_ok) return -1.0;
+	return 1e9 * t / CLOCKS_PER_SEC / ((double)reps * size);
+}
+
+/** Makes l the size elements of keys, which are width apart.
+ @return	Success. */
+static int fill_list(struct List *const l, const size_t width, const int size, const char *const keys) {
+	int i;
+
+	ListClear(l);
+	for(i = 0; i < size; i++) if(!ListAdd(l, keys + width * i)) return 0;
+	return -1;
+}
+
+/** Makes a the size elements of keys.
+ @return	Success. */
+static int fill_array(struct Array *const a, const int size, const char *const keys) {
+	int i;
+
+	a->size = 0;
+	for(i = 0; i < size; i++) if(!array_add(a, keys + a->width * i)) return 0;
+	return -1;
+}
+
+/** Adds a copy of e to the end of a, doubling it if it's full.
+ @return	Success. */
+static int array_add(struct Array *const a, const void *const e) {
+	char *data;
+	size_t capacity;
+
+	if(a->size >= a->capacity) {
+		capacity = a->capacity ? a->capacity * 2 : 8;
+		if(!(data = realloc(a->data, capacity * a->width))) return 0;
+		a->data = data;
+		a->capacity = capacity;
+	}
+	memcpy(a->data + a->size * a->width, e, a->width);
+	a->size++;
+	return -1;
+}
+
+/** @implements	ListAction */
+static void add_key(void *const e) { sum += *(int *)e; }
+
+/** @implements	ListPredicate */
+static int is_any(void *const e, void *const param) {
+	(void)param;
+	return *(int *)e >= 0;
+}
+
+/** @implements	ListPredicate */
+static int is_odd(void *const e, void *const param) {
+	(void)param;
+	return *(int *)e & 1;
+}
+
+/** By the key in front.
+ @implements	ListMetric */
+static int compare(const void *a, const void *b) {
+	const int x = *(const int *)a, y = *(const int *)b;
+	return (x > y) - (x < y);
+}
+
+/** Xorshift, so it's the same everywhere.
+ @return	[0, 2^32). */
+static unsigned long random_next(void) {
+	seed ^= (seed << 13) & 0xffffffffUL;
+	seed ^= seed >> 17;
+	seed ^= (seed << 5) & 0xffffffffUL;
+	return seed;
+}
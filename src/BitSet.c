@@ -0,0 +1,244 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* malloc calloc free */
+#include <string.h>	/* memset memcpy strerror */
+#include <errno.h>	/* global errno */
+#include "BitSet.h"
+
+/** A set of the integers [0, size), one bit each, like BitSet in Java. Since
+ the bits are packed into indices when the graph is frozen, the sets are dense
+ and the set algebra goes a word at a time. The size is fixed by the
+ constructor; indices outside it are ignored.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+typedef unsigned long Word;
+
+static const int word_bits = (int)(sizeof(Word) * 8);
+
+enum Error {
+	E_NO_ERROR,
+	E_ERRNO,
+	E_SIZE
+};
+
+struct BitSet {
+	Word *words;
+	int size;				/* number of bits */
+	int words_size;			/* number of words */
+	enum Error error;
+	int errno_copy;
+};
+
+/* global errors for allocation */
+static enum Error global_error;
+static int        global_errno_copy;
+
+/* private prototypes */
+
+static int is_compatible(struct BitSet *const s, const struct BitSet *const t);
+static int count(Word w);
+
+/* public */
+
+/** Constructs an empty set.
+ @param size	The number of integers, [0, size), that can be members.
+ @return		An object.
+ @throws		call @see{BitSetError(0)} to see errors */
+struct BitSet *BitSet(const int size) {
+	struct BitSet *s;
+
+	if(size < 0) {
+		global_error = E_SIZE;
+		return 0;
+	}
+	if(!(s = malloc(sizeof(struct BitSet)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		return 0;
+	}
+	s->size       = size;
+	s->words_size = (size + word_bits - 1) / word_bits;
+	s->error      = E_NO_ERROR;
+	s->errno_copy = 0;
+	if(!(s->words = calloc(s->words_size ? s->words_size : 1, sizeof(Word)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		BitSet_(&s);
+		return 0;
+	}
+
+	return s;
+}
+
+/** Destructor.
+ @param s_ptr	A reference to the object that is to be deleted. */
+void BitSet_(struct BitSet **const s_ptr) {
+	struct BitSet *s;
+
+	if(!s_ptr || !(s = *s_ptr)) return;
+	free(s->words);
+	free(s);
+	*s_ptr = 0;
+}
+
+/** @return	The number of integers that can be members. */
+int BitSetSize(const struct BitSet *const s) {
+	if(!s) return 0;
+	return s->size;
+}
+
+/** @return	The number of members. */
+int BitSetCount(const struct BitSet *const s) {
+	int i, no = 0;
+
+	if(!s) return 0;
+	for(i = 0; i < s->words_size; i++) no += count(s->words[i]);
+	return no;
+}
+
+/** @return	True if i is a member. */
+int BitSetHas(const struct BitSet *const s, const int i) {
+	if(!s || i < 0 || i >= s->size) return 0;
+	return (s->words[i / word_bits] >> (i % word_bits)) & 1 ? -1 : 0;
+}
+
+/** Makes i a member. */
+void BitSetAdd(struct BitSet *const s, const int i) {
+	if(!s || i < 0 || i >= s->size) return;
+	s->words[i / word_bits] |= (Word)1 << (i % word_bits);
+}
+
+/** Makes i not a member. */
+void BitSetRemove(struct BitSet *const s, const int i) {
+	if(!s || i < 0 || i >= s->size) return;
+	s->words[i / word_bits] &= ~((Word)1 << (i % word_bits));
+}
+
+/** Removes all the members. */
+void BitSetClear(struct BitSet *const s) {
+	if(!s) return;
+	memset(s->words, 0, sizeof(Word) * s->words_size);
+}
+
+/** Iterates in order: for(i = BitSetNext(s, 0); i != -1;
+ i = BitSetNext(s, i + 1)).
+ @return	The first member that is at least i, or -1 if there are none. */
+int BitSetNext(const struct BitSet *const s, const int i) {
+	int w, b;
+	Word word;
+
+	if(!s || i >= s->size) return -1;
+	if(i < 0) return BitSetNext(s, 0);
+	w = i / word_bits;
+	word = s->words[w] >> (i % word_bits);
+	if(word) {
+		for(b = i; !(word & 1); word >>= 1, b++);
+		return b;
+	}
+	for(w++; w < s->words_size; w++) {
+		if(!(word = s->words[w])) continue;
+		for(b = w * word_bits; !(word & 1); word >>= 1, b++);
+		return b;
+	}
+	return -1;
+}
+
+/** s becomes the union of s and t.
+ @return	Success.
+ @throws	E_SIZE: the sets are different sizes. */
+int BitSetUnion(struct BitSet *const s, const struct BitSet *const t) {
+	int i;
+
+	if(!is_compatible(s, t)) return 0;
+	for(i = 0; i < s->words_size; i++) s->words[i] |= t->words[i];
+	return -1;
+}
+
+/** s becomes the intersection of s and t.
+ @return	Success.
+ @throws	E_SIZE: the sets are different sizes. */
+int BitSetIntersection(struct BitSet *const s, const struct BitSet *const t) {
+	int i;
+
+	if(!is_compatible(s, t)) return 0;
+	for(i = 0; i < s->words_size; i++) s->words[i] &= t->words[i];
+	return -1;
+}
+
+/** s becomes s without the members of t.
+ @return	Success.
+ @throws	E_SIZE: the sets are different sizes. */
+int BitSetDifference(struct BitSet *const s, const struct BitSet *const t) {
+	int i;
+
+	if(!is_compatible(s, t)) return 0;
+	for(i = 0; i < s->words_size; i++) s->words[i] &= ~t->words[i];
+	return -1;
+}
+
+/** @return	The bytes that @see{BitSetSave} writes. */
+size_t BitSetBytes(const struct BitSet *const s) {
+	if(!s) return 0;
+	return sizeof(Word) * s->words_size;
+}
+
+/** Writes the members to data, which is @see{BitSetBytes} long and need not
+ be aligned, so lots of sets can be kept flat. */
+void BitSetSave(const struct BitSet *const s, void *const data) {
+	if(!s || !data) return;
+	memcpy(data, s->words, sizeof(Word) * s->words_size);
+}
+
+/** Reads the members from data, as written by @see{BitSetSave} from a set of
+ the same size. */
+void BitSetLoad(struct BitSet *const s, const void *const data) {
+	if(!s || !data) return;
+	memcpy(s->words, data, sizeof(Word) * s->words_size);
+}
+
+/** See what's the error if something goes wrong. The error is reset by this
+ action.
+ @param s	BitSet, or null for the constructor.
+ @return	The last error string.
+ @throws	!s, E_NO_ERR */
+char *BitSetError(struct BitSet *const s) {
+	char *str = 0;
+	enum Error *error_p;
+	int *errno_p;
+
+	error_p = s ? &s->error      : &global_error;
+	errno_p = s ? &s->errno_copy : &global_errno_copy;
+	switch(*error_p) {
+		case E_NO_ERROR:
+			break;
+		case E_ERRNO:
+			str = strerror(*errno_p);
+			*errno_p = 0;
+			break;
+		case E_SIZE:
+			str = "sets are not the same size";
+			break;
+	}
+	*error_p = 0;
+	return str;
+}
+
+/* private */
+
+static int is_compatible(struct BitSet *const s, const struct BitSet *const t) {
+	if(!s || !t) return 0;
+	if(s->size != t->size) { s->error = E_SIZE; return 0; }
+	return -1;
+}
+
+/** Kernighan. */
+static int count(Word w) {
+	int no;
+
+	for(no = 0; w; no++) w &= w - 1;
+	return no;
+}
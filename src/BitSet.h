@@ -0,0 +1,22 @@
+struct BitSet;
+
+struct BitSet *BitSet(const int size);
+void BitSet_(struct BitSet **const s_ptr);
+int BitSetSize(const struct BitSet *const s);
+int BitSetCount(const struct BitSet *const s);
+
+int BitSetHas(const struct BitSet *const s, const int i);
+void BitSetAdd(struct BitSet *const s, const int i);
+void BitSetRemove(struct BitSet *const s, const int i);
+void BitSetClear(struct BitSet *const s);
+int BitSetNext(const struct BitSet *const s, const int i);
+
+int BitSetUnion(struct BitSet *const s, const struct BitSet *const t);
+int BitSetIntersection(struct BitSet *const s, const struct BitSet *const t);
+int BitSetDifference(struct BitSet *const s, const struct BitSet *const t);
+
+size_t BitSetBytes(const struct BitSet *const s);
+void BitSetSave(const struct BitSet *const s, void *const data);
+void BitSetLoad(struct BitSet *const s, const void *const data);
+
+char *BitSetError(struct BitSet *const s);
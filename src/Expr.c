@@ -0,0 +1,389 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* malloc free strtol */
+#include <string.h>	/* strlen strerror */
+#include <ctype.h>	/* isspace isalpha isdigit */
+#include <errno.h>	/* global errno */
+#include "BitSet.h"
+#include "Expr.h"
+
+/** A test expression, like the available bits of a misn, "b3 & (!b9 | !b5),"
+ parsed in full: | is looser than &, which is looser than !, and terms next to
+ each other are and'ed. It's parsed into a tree, and the tree is compiled into
+ postfix code with the nots pushed down to the bits, so it's evaluated in one
+ pass over an array with a small stack, and no recursion or allocation; lots of
+ states can be tested fast. Terms that are not bits, like outfits, "o128," or
+ gender, "g1," are taken to be true whichever way they go.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+/* the code is op | operand << op_bits */
+enum Op { X_TRUE, X_FALSE, X_BIT, X_NOT_BIT, X_AND, X_OR };
+static const int op_bits = 3;
+static const int op_mask = 7;
+static const long bit_max = 0xfffffff; /* fits in the operand */
+
+static const int stack_size = 64; /* the deepest nesting, too */
+
+enum Node { N_TRUE, N_BIT, N_UNKNOWN, N_NOT, N_AND, N_OR };
+
+struct Tree {
+	enum Node node;
+	int bit;				/* N_BIT */
+	int a, b;				/* children, indices into the trees */
+};
+
+enum Error {
+	E_NO_ERROR,
+	E_ERRNO,
+	E_SYNTAX,
+	E_DEPTH,
+	E_RANGE
+};
+
+struct Expr {
+	int *code;
+	int code_size;
+	enum Error error;
+	int errno_copy;
+};
+
+/* the state of parsing one text */
+struct Parse {
+	const char *s;			/* the next character */
+	struct Tree *trees;
+	int trees_size;
+	int depth;
+	int *code;				/* compiling */
+	int code_size, stack, stack_max;
+	enum Error error;
+};
+
+/* global errors for the constructor */
+static enum Error global_error;
+static int        global_errno_copy;
+
+/* private prototypes */
+
+static int parse_or(struct Parse *const p);
+static int parse_and(struct Parse *const p);
+static int parse_not(struct Parse *const p);
+static int tree(struct Parse *const p, const enum Node node, const int bit, const int a, const int b);
+static void skip(struct Parse *const p);
+static void compile(struct Parse *const p, const int t, const int is_not);
+static void emit(struct Parse *const p, const enum Op op, const int operand);
+static int evaluate(const struct Expr *const e, const struct BitSet *const set, const struct BitSet *const clear, const int is_could);
+
+/* public */
+
+/** Constructor.
+ @param text	The expression; an empty one is true.
+ @return		An object.
+ @throws		!text, E_SYNTAX, E_DEPTH, E_RANGE, E_ERRNO; call
+				@see{ExprError(0)} to see errors */
+struct Expr *Expr(const char *const text) {
+	struct Parse p;
+	struct Expr *e;
+	const size_t size = text ? strlen(text) * 2 + 1 : 0;
+	int root;
+
+	if(!text) return 0;
+
+	/* a character is at most a term or a not, and an and between terms */
+	p.s          = text;
+	p.trees_size = 0;
+	p.depth      = 0;
+	p.code_size  = 0;
+	p.stack      = 0;
+	p.stack_max  = 0;
+	p.error      = E_NO_ERROR;
+	p.code       = 0;
+	e            = 0;
+	if(!(p.trees = malloc(sizeof *p.trees * size))
+		|| !(p.code = malloc(sizeof *p.code * size))
+		|| !(e = malloc(sizeof *e))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		free(e);
+		free(p.code);
+		free(p.trees);
+		return 0;
+	}
+
+	skip(&p);
+	if(!*p.s) {
+		root = tree(&p, N_TRUE, 0, 0, 0);
+	} else if((root = parse_or(&p)) != -1 && *p.s) {
+		/* something left over, like a ')' */
+		p.error = E_SYNTAX;
+	}
+	if(!p.error) compile(&p, root, 0);
+	free(p.trees);
+	if(p.error) {
+		global_error = p.error;
+		free(p.code);
+		free(e);
+		return 0;
+	}
+
+	e->code       = p.code;
+	e->code_size  = p.code_size;
+	e->error      = E_NO_ERROR;
+	e->errno_copy = 0;
+
+	return e;
+}
+
+/** Destructor.
+ @param e_ptr	A reference to the object that is to be deleted. */
+void Expr_(struct Expr **const e_ptr) {
+	struct Expr *e;
+
+	if(!e_ptr || !(e = *e_ptr)) return;
+	free(e->code);
+	free(e);
+	*e_ptr = 0;
+}
+
+/** Replaces the bit numbers with map(bit, param), eg, to indices of the bits
+ that are known; a bit that maps to -1 is never set.
+ @param map	The mapping. */
+void ExprMap(struct Expr *const e, const ExprMapping map, void *const param) {
+	int *c, *end, op, bit;
+
+	if(!e || !map) return;
+	for(c = e->code, end = c + e->code_size; c < end; c++) {
+		op = *c & op_mask;
+		if(op != X_BIT && op != X_NOT_BIT) continue;
+		if((bit = map(*c >> op_bits, param)) < 0 || bit > bit_max) {
+			*c = op == X_BIT ? X_FALSE : X_TRUE;
+		} else {
+			*c = op | bit << op_bits;
+		}
+	}
+}
+
+/** @param set	The bits that are set; the others are clear.
+ @return		Whether e is true. */
+int ExprEvaluate(const struct Expr *const e, const struct BitSet *const set) {
+	return evaluate(e, set, 0, 0);
+}
+
+/** Whether e could be true if each bit can be set if it's in can_set, and
+ can be clear if it's in can_clear, not counting whether that can happen at
+ the same time; so if it's false, e can never be true.
+ @param can_clear	If it's null, all bits can be clear.
+ @return			Whether e could be true. */
+int ExprCould(const struct Expr *const e, const struct BitSet *const can_set, const struct BitSet *const can_clear) {
+	return evaluate(e, can_set, can_clear, -1);
+}
+
+/** See what's the error if something goes wrong. The error is reset by this
+ action.
+ @param e	Expr, or null for the constructor.
+ @return	The last error string.
+ @throws	!e, E_NO_ERR */
+char *ExprError(struct Expr *const e) {
+	char *str = 0;
+	enum Error *error_p;
+	int *errno_p;
+
+	error_p = e ? &e->error      : &global_error;
+	errno_p = e ? &e->errno_copy : &global_errno_copy;
+	switch(*error_p) {
+		case E_NO_ERROR:
+			break;
+		case E_ERRNO:
+			str = strerror(*errno_p);
+			*errno_p = 0;
+			break;
+		case E_SYNTAX:
+			str = "syntax error";
+			break;
+		case E_DEPTH:
+			str = "nested too deeply";
+			break;
+		case E_RANGE:
+			str = "bit out of range";
+			break;
+	}
+	*error_p = 0;
+	return str;
+}
+
+/* private */
+
+/** or := and { '|' and }
+ @return	The tree, or -1. */
+static int parse_or(struct Parse *const p) {
+	int t, u;
+
+	if((t = parse_and(p)) == -1) return -1;
+	while(*p->s == '|') {
+		p->s++;
+		skip(p);
+		if((u = parse_and(p)) == -1) return -1;
+		t = tree(p, N_OR, 0, t, u);
+	}
+	return t;
+}
+
+/** and := not { ['&'] not }
+ @return	The tree, or -1. */
+static int parse_and(struct Parse *const p) {
+	int t, u;
+
+	if((t = parse_not(p)) == -1) return -1;
+	for( ; ; ) {
+		if(*p->s == '&') {
+			p->s++;
+			skip(p);
+		} else if(*p->s != '!' && *p->s != '(' && !isalpha((unsigned char)*p->s)) {
+			break;
+		}
+		if((u = parse_not(p)) == -1) return -1;
+		t = tree(p, N_AND, 0, t, u);
+	}
+	return t;
+}
+
+/** not := '!' not | '(' or ')' | term; the depth is limited so the stack
+ can't overflow.
+ @return	The tree, or -1. */
+static int parse_not(struct Parse *const p) {
+	const char *start;
+	char *end;
+	long bit;
+	int t;
+
+	if(++p->depth > stack_size) {
+		p->error = E_DEPTH;
+		return -1;
+	}
+	if(*p->s == '!') {
+		p->s++;
+		skip(p);
+		if((t = parse_not(p)) != -1) t = tree(p, N_NOT, 0, t, 0);
+	} else if(*p->s == '(') {
+		p->s++;
+		skip(p);
+		if((t = parse_or(p)) != -1) {
+			if(*p->s == ')') {
+				p->s++;
+				skip(p);
+			} else if(*p->s) {
+				p->error = E_SYNTAX;
+				t = -1;
+			} /* else the end closes it, as a lot of the data expects */
+		}
+	} else if(isalpha((unsigned char)*p->s)) {
+		start = p->s++;
+		bit = strtol(p->s, &end, 10);
+		if(end == p->s) bit = -1;
+		p->s = end;
+		skip(p);
+		if(*start != 'b' && *start != 'B') {
+			t = tree(p, N_UNKNOWN, 0, 0, 0);
+		} else if(bit < 0 || bit > bit_max) {
+			p->error = bit < 0 ? E_SYNTAX : E_RANGE;
+			t = -1;
+		} else {
+			t = tree(p, N_BIT, (int)bit, 0, 0);
+		}
+	} else {
+		p->error = E_SYNTAX;
+		t = -1;
+	}
+	p->depth--;
+	return t;
+}
+
+/** @return	A new tree. */
+static int tree(struct Parse *const p, const enum Node node, const int bit, const int a, const int b) {
+	struct Tree *const t = p->trees + p->trees_size;
+
+	t->node = node;
+	t->bit  = bit;
+	t->a    = a;
+	t->b    = b;
+	return p->trees_size++;
+}
+
+/** Skips the white-space. */
+static void skip(struct Parse *const p) {
+	while(isspace((unsigned char)*p->s)) p->s++;
+}
+
+/** Compiles tree t to postfix with the nots taken down to the bits by De
+ Morgan; the recursion is no deeper than the parsing was. */
+static void compile(struct Parse *const p, const int t, const int is_not) {
+	const struct Tree *const tr = p->trees + t;
+
+	switch(tr->node) {
+		case N_TRUE:
+		case N_UNKNOWN:
+			emit(p, X_TRUE, 0);
+			break;
+		case N_BIT:
+			emit(p, is_not ? X_NOT_BIT : X_BIT, tr->bit);
+			break;
+		case N_NOT:
+			compile(p, tr->a, !is_not);
+			break;
+		case N_AND:
+		case N_OR:
+			compile(p, tr->a, is_not);
+			compile(p, tr->b, is_not);
+			emit(p, (tr->node == N_AND) != !!is_not ? X_AND : X_OR, 0);
+			break;
+	}
+}
+
+/** Appends an instruction and keeps track of the stack. */
+static void emit(struct Parse *const p, const enum Op op, const int operand) {
+	p->code[p->code_size++] = op | operand << op_bits;
+	if(op == X_AND || op == X_OR) {
+		p->stack--;
+	} else if(++p->stack > p->stack_max) {
+		p->stack_max = p->stack;
+		if(p->stack_max > stack_size) p->error = E_DEPTH;
+	}
+}
+
+/** Runs the code; @see{ExprEvaluate} and @see{ExprCould}. */
+static int evaluate(const struct Expr *const e, const struct BitSet *const set, const struct BitSet *const clear, const int is_could) {
+	unsigned char stack[64]; /* stack_size */
+	const int *c, *end;
+	int sp = 0;
+
+	if(!e) return 0;
+	for(c = e->code, end = c + e->code_size; c < end; c++) {
+		switch(*c & op_mask) {
+			case X_TRUE:
+				stack[sp++] = 1;
+				break;
+			case X_FALSE:
+				stack[sp++] = 0;
+				break;
+			case X_BIT:
+				stack[sp++] = BitSetHas(set, *c >> op_bits) ? 1 : 0;
+				break;
+			case X_NOT_BIT:
+				if(!is_could) stack[sp++] = BitSetHas(set, *c >> op_bits) ? 0 : 1;
+				else stack[sp++] = !clear || BitSetHas(clear, *c >> op_bits) ? 1 : 0;
+				break;
+			case X_AND:
+				sp--;
+				stack[sp - 1] &= stack[sp];
+				break;
+			case X_OR:
+				sp--;
+				stack[sp - 1] |= stack[sp];
+				break;
+		}
+	}
+	return stack[0] ? -1 : 0;
+}
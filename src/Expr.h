@@ -0,0 +1,13 @@
+struct Expr;
+struct BitSet;
+
+typedef int (*ExprMapping)(const int bit, void *const param);
+
+struct Expr *Expr(const char *const text);
+void Expr_(struct Expr **const e_ptr);
+void ExprMap(struct Expr *const e, const ExprMapping map, void *const param);
+
+int ExprEvaluate(const struct Expr *const e, const struct BitSet *const set);
+int ExprCould(const struct Expr *const e, const struct BitSet *const can_set, const struct BitSet *const can_clear);
+
+char *ExprError(struct Expr *const e);
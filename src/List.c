@@ -3,14 +3,27 @@
 
 #include <stdlib.h> /* malloc free */
 #include <stdio.h>  /* fprintf */
+#include <stddef.h>	/* offsetof */
 #include <string.h>	/* memcpy memmove strerror */
 #include <errno.h>	/* global errno */
+#include <pthread.h>	/* the counts are shared */
 #include "List.h"
 
 /** List like ArrayList in Java, but dangerous and unsafe because C. The
  structs are stored in a contagious array, not pointers. You specify sizeof in
  the constructor.
  <p>
+ Lists can be allocated in a {ListArena}, in which case they are never freed
+ individually, (@see{List_} does nothing,) only all at once with the arena.
+ This is for many small lists that live as long as the programme.
+ <p>
+ Lists of a few small elements are stored inside the List, and only go to the
+ heap (or arena) when they outgrow it.
+ <p>
+ Every call to the allocator can be counted, @see{ListCounting}; lists are
+ used on more than one thread, so the count has a lock, and it's only taken
+ when they are being counted.
+ <p>
  Incomplete and untested!
  
  @fixme		Have an extra level of indirection to avoid the mess of deletion,
@@ -21,6 +34,7 @@
 
 static const int fibonacci6 = 8;
 static const int fibonacci7 = 13;
+static const size_t arena_block = 1 << 16; /* bytes */
 
 enum Error {
 	E_NO_ERROR,
@@ -32,17 +46,38 @@ enum Error {
 enum Flags {
 	F_NO_FLAGS = 0,
 	F_LOCKED = 1,
-	F_DEBUG = 2
+	F_DEBUG = 2,
+	F_SORTED = 4
+};
+
+/* the alignment of anything allocated from an arena */
+union Align {
+	long l;
+	double d;
+	void *p;
+};
+
+struct Block {
+	struct Block *prev;
+	size_t capacity;		/* the size of data in bytes */
+	union Align data[1];	/* capacity bytes */
+};
+
+struct ListArena {
+	struct Block *block;	/* the current block, linked to the previous ones */
+	size_t used;			/* bytes of the current block */
 };
 
 struct List {
 
+	char   *array;		/* the actual list, implemented as bytes * width */
 	size_t width;		/* the size of the elements in bytes */
 	int    size;		/* the size of the list */
 	int    capacity[2];	/* Fibonacci, [0] is the capacity, [1] is the next */
+	union Align small[2]; /* array is this until it overflows */
 
-	/*ListMetric metric;	metric can be null */
-	char   *array;		/* the actual list, implemented as bytes * width */
+	struct ListArena *arena; /* if it's in an arena */
+	ListMetric metric;	/* the metric it was sorted by when F_SORTED */
 
 	char   *iterator;	/* controls iteration */
 	int    last_index;
@@ -58,9 +93,16 @@ struct List {
 static enum Error global_error;
 static int        global_errno_copy;
 
+/* all the calls to the allocator since counting started */
+static int is_counting;
+static pthread_mutex_t count_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t count_allocations, count_bytes;
+
 /* private prototypes */
 
 static void grow(int *const a, int *const b);
+static void *allocate(struct ListArena *const a, const size_t size);
+static void count(const size_t size);
 
 /* public */
 
@@ -69,22 +111,38 @@ static void grow(int *const a, int *const b);
  @return		An object.
  @throws		width <= 0; call @see{ListGetError(0)} to see errors */
 struct List *List(const size_t width) {
+	return ListIn(0, width);
+}
+
+/** Constructs an empty list in an arena.
+ @param a		The arena; if it's null, it's the same as @see{List}.
+ @param width	The size of the objects that go in the list.
+ @return		An object that lives as long as the arena.
+ @throws		width <= 0; call @see{ListGetError(0)} to see errors */
+struct List *ListIn(struct ListArena *const a, const size_t width) {
 	struct List *l;
 
 	if(width <= 0) return 0;
 
-	if(!(l = malloc(sizeof(struct List)))) {
+	if(!(l = allocate(a, sizeof(struct List)))) {
 		global_error = E_ERRNO;
 		global_errno_copy = errno;
 		return 0;
 	}
 
+	l->array       = 0;
 	l->width       = width;
 	l->size        = 0;
-	l->capacity[0] = fibonacci6;
-	l->capacity[1] = fibonacci7;
+	if(width <= sizeof l->small) {
+		l->capacity[0] = (int)(sizeof l->small / width);
+		l->capacity[1] = fibonacci6;
+	} else {
+		l->capacity[0] = fibonacci6;
+		l->capacity[1] = fibonacci7;
+	}
 
-	l->array       = 0;
+	l->arena       = a;
+	l->metric      = 0;
 
 	l->iterator    = 0;
 	l->last_index  = 0;
@@ -98,7 +156,9 @@ struct List *List(const size_t width) {
 	if((l->flags & F_DEBUG)) fprintf(stderr, "List: new, capacity %d, #%p.\n",
 		l->capacity[0], (void *)l);
 
-	if(!(l->array = malloc(l->capacity[0] * width))) {
+	if(width <= sizeof l->small) {
+		l->array = (char *)l->small;
+	} else if(!(l->array = allocate(a, l->capacity[0] * width))) {
 		global_error = E_ERRNO;
 		global_errno_copy = errno;
 		List_(&l);
@@ -108,18 +168,20 @@ struct List *List(const size_t width) {
 	return l;
 }
 
-/** Destructor.
+/** Destructor. If the list is in an arena, it's only forgotten.
  @param l_ptr	A reference to the object that is to be deleted. */
 void List_(struct List **const l_ptr) {
 	struct List *l;
 
 	if(!l_ptr || !(l = *l_ptr)) return;
 
+	if(l->arena) { *l_ptr = 0; return; }
+
 	if((l->flags & F_LOCKED)) fprintf(stderr, "~List: erasing #%p while it is "
 		"locked.\n", (void *)l);
 	if((l->flags & F_DEBUG)) fprintf(stderr, "~List: erase, #%p.\n", (void *)l);
 
-	free(l->array);
+	if(l->array != (char *)l->small) free(l->array);
 	free(l);
 
 	*l_ptr = 0;
@@ -149,7 +211,15 @@ int ListEnsureCapacity(struct List *const l, const int min_capacity) {
 		grow(&c0, &c1);
 		if(c0 < 0) { l->error = E_TOO_LARGE; return 0; }
 	}
-	if(!(array = realloc(l->array, c0 * l->width))) {
+	if(l->arena || l->array == (char *)l->small) {
+		if((array = allocate(l->arena, c0 * l->width))) {
+			memcpy(array, l->array, l->size * l->width);
+		}
+	} else {
+		count(c0 * l->width);
+		array = realloc(l->array, c0 * l->width);
+	}
+	if(!array) {
 		l->error = E_ERRNO;
 		l->errno_copy = errno;
 		return 0;
@@ -190,6 +260,7 @@ int ListAdd(struct List *const l, const void *const e) {
 
 	memcpy(l->array + l->size * l->width, e, l->width);
 	l->size++;
+	l->flags &= ~F_SORTED;
 
 	return -1;
 }
@@ -295,30 +366,29 @@ int ListShortCircuit(struct List *const l, const ListPredicate predicate, void *
 }
 
 /* "Removes all of the elements of this [List] that satisfy the given
- predicate."
+ predicate." The order of the remaining elements is preserved, so a sorted
+ list stays sorted.
  @param predicate	The predicate.
  @return			The number of deletions. */
 int ListRemoveIf(struct List *const l, const ListPredicate predicate, void *const param) {
-	int i, no = 0;
-	char *a;
+	int i, no;
+	char *a, *b;
 
 	if(!l || !predicate) return 0;
 
 	if((l->flags & F_LOCKED)) { l->error = E_LOCKED; return 0; }
 	l->flags |= F_LOCKED;
 
-	for(i = 0, a = l->array; i < l->size; ) {
+	/* a is read, b is written */
+	for(i = 0, a = b = l->array; i < l->size; i++, a += l->width) {
 		l->last_index = i;
-		if((*predicate)(a, param)) {
-			no++;
-			if(i >= --l->size) break;
-			memcpy(l->array + l->size * l->width, l->array + i * l->width, l->width);
-		} else {
-			i++;
-			a += l->width;
-		}
+		if((*predicate)(a, param)) continue;
+		if(a != b) memcpy(b, a, l->width);
+		b += l->width;
 	}
 	l->last_index = 0;
+	no = l->size - (int)((b - l->array) / l->width);
+	l->size -= no;
 
 	l->flags &= ~F_LOCKED;
 
@@ -362,13 +432,49 @@ int ListCompare(const struct List *const a, const struct List *const b, const Li
 }
 
 /** "Sorts this list according to the order induced by the specified
- Comparator."
+ Comparator." The list remembers that it is sorted until it's added to, so
+ sorting it again by the same metric is free.
  @fixme			Lol! so slow! apply indirection.
  @param l		The List.
  @param metric	"Comparator used to compare list elements." */
-void ListSort(const struct List *const l, const ListMetric metric) {
+void ListSort(struct List *const l, const ListMetric metric) {
 	if(!l || !metric) return;
+	if((l->flags & F_SORTED) && l->metric == metric) return;
 	qsort(l->array, l->size, l->width, metric);
+	l->flags |= F_SORTED;
+	l->metric = metric;
+}
+
+/** @return		Whether the list is known to be sorted by metric. */
+int ListIsSorted(const struct List *const l, const ListMetric metric) {
+	if(!l) return 0;
+	return (l->flags & F_SORTED) && l->metric == metric;
+}
+
+/** Removes consecutive duplicates; sort it first to remove them all.
+ @param l		The List.
+ @param metric	Elements that are zero apart are duplicates.
+ @return		The number of deletions.
+ @throws		!l, !metric; E_LOCKED */
+int ListUnique(struct List *const l, const ListMetric metric) {
+	int i, no;
+	char *a, *b;
+
+	if(!l || !metric || l->size < 2) return 0;
+
+	if((l->flags & F_LOCKED)) { l->error = E_LOCKED; return 0; }
+
+	/* a is read, b is the last one kept */
+	for(i = 1, a = b = l->array; i < l->size; i++) {
+		a += l->width;
+		if(!metric(a, b)) continue;
+		b += l->width;
+		if(a != b) memcpy(b, a, l->width);
+	}
+	no = l->size - (int)((b - l->array) / l->width) - 1;
+	l->size -= no;
+
+	return no;
 }
 
 /* ----- */
@@ -594,6 +700,58 @@ void ListTrimToSize(struct List *l) {
 }
 #endif
 
+/** Constructs an empty arena.
+ @return	An object.
+ @throws	call @see{ListGetError(0)} to see errors */
+struct ListArena *ListArena(void) {
+	struct ListArena *a;
+
+	count(sizeof(struct ListArena));
+	if(!(a = malloc(sizeof(struct ListArena)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		return 0;
+	}
+	a->block = 0;
+	a->used  = 0;
+
+	return a;
+}
+
+/** Destructor; frees all the lists that were made in the arena at once.
+ @param a_ptr	A reference to the object that is to be deleted. */
+void ListArena_(struct ListArena **const a_ptr) {
+	struct ListArena *a;
+	struct Block *b;
+
+	if(!a_ptr || !(a = *a_ptr)) return;
+	while((b = a->block)) {
+		a->block = b->prev;
+		free(b);
+	}
+	free(a);
+
+	*a_ptr = 0;
+}
+
+/** Starts counting what the lists ask of the allocator, for @see{ListCount}.
+ It has to be called before the lists are used on other threads. */
+void ListCounting(void) {
+	is_counting = -1;
+}
+
+/** Gets how much the lists have asked of the allocator since
+ @see{ListCounting}; the memory that has been freed is still counted.
+ @param allocations	Set to the number of calls to malloc or realloc, if not
+					null.
+ @param bytes		Set to the bytes that were asked for, if not null. */
+void ListCount(size_t *const allocations, size_t *const bytes) {
+	pthread_mutex_lock(&count_lock);
+	if(allocations) *allocations = count_allocations;
+	if(bytes)       *bytes       = count_bytes;
+	pthread_mutex_unlock(&count_lock);
+}
+
 /** See what's the error if something goes wrong. The error is reset by this
  action.
  @param l	List
@@ -626,6 +784,51 @@ char *ListError(struct List *const l) {
 
 /* private */
 
+/** Allocates from the arena, or from the heap if the arena is null; arena
+ memory is aligned and is only freed with the arena. Large allocations get
+ their own block so the current one is not wasted.
+ @return	The memory or null; errno is set. */
+static void *allocate(struct ListArena *const a, const size_t size) {
+	const size_t aligned = (size + sizeof(union Align) - 1)
+		/ sizeof(union Align) * sizeof(union Align);
+	size_t block;
+	struct Block *b;
+
+	if(!a) {
+		count(size);
+		return malloc(size);
+	}
+	if(a->block && a->block->capacity - a->used >= aligned) {
+		a->used += aligned;
+		return (char *)a->block->data + a->used - aligned;
+	}
+	block = offsetof(struct Block, data)
+		+ (aligned > arena_block >> 2 ? aligned : arena_block);
+	count(block);
+	if(!(b = malloc(block))) return 0;
+	if(aligned > arena_block >> 2 && a->block) {
+		/* behind the current block */
+		b->capacity = aligned;
+		b->prev = a->block->prev;
+		a->block->prev = b;
+	} else {
+		b->capacity = aligned > arena_block >> 2 ? aligned : arena_block;
+		b->prev = a->block;
+		a->block = b;
+		a->used = aligned;
+	}
+	return b->data;
+}
+
+/** Counts a call to the allocator for size bytes, if it's counting. */
+static void count(const size_t size) {
+	if(!is_counting) return;
+	pthread_mutex_lock(&count_lock);
+	count_allocations++;
+	count_bytes += size;
+	pthread_mutex_unlock(&count_lock);
+}
+
 /** Fibonacci growing thing. */
 static void grow(int *const a, int *const b) {
 	*a ^= *b;
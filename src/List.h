@@ -1,10 +1,12 @@
 struct List;
+struct ListArena;
 
 typedef void (*ListAction)(void *const);
 typedef int (*ListPredicate)(void *const element, void *const param);
 typedef int (*ListMetric)(const void *a, const void *b); /* qsort compatible */
 
 struct List *List(const size_t width);
+struct List *ListIn(struct ListArena *const a, const size_t width);
 void List_(struct List **const l_ptr);
 int ListEnsureCapacity(struct List *const l, const int min_capacity);
 int ListSize(const struct List *const l);
@@ -21,10 +23,18 @@ int ListRemoveIf(struct List *const l, const ListPredicate predicate, void *cons
 
 /*void ListMetric(const struct List *const l, const ListMetric metric);*/
 int ListCompare(const struct List *const a, const struct List *const b, const ListMetric metric);
-void ListSort(const struct List *const l, const ListMetric metric);
+void ListSort(struct List *const l, const ListMetric metric);
+int ListIsSorted(const struct List *const l, const ListMetric metric);
+int ListUnique(struct List *const l, const ListMetric metric);
 
 int ListIndex(const struct List *const l);
 void ListSetParam(struct List *const l, void *const param);
 void *ListGetParam(struct List *const l);
 
+struct ListArena *ListArena(void);
+void ListArena_(struct ListArena **const a_ptr);
+
+void ListCounting(void);
+void ListCount(size_t *const allocations, size_t *const bytes);
+
 char *ListError(struct List *const l);
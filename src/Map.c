@@ -0,0 +1,195 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* malloc free */
+#include <string.h>	/* strerror */
+#include <errno.h>	/* global errno */
+#include "Map.h"
+
+/** Map from int to int, like HashMap<Integer, Integer> in Java. It's open
+ addressed with linear probing in one array, so it's only as big as the keys
+ that are actually in it. There is no removal; @see{MapClear} forgets
+ everything.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+static const int initial_capacity = 16; /* power of two */
+
+enum Error {
+	E_NO_ERROR,
+	E_ERRNO,
+	E_TOO_LARGE
+};
+
+struct Entry {
+	int is_used;
+	int key;
+	int value;
+};
+
+struct Map {
+	struct Entry *entries;	/* capacity of them */
+	int capacity;			/* power of two */
+	int size;				/* at most half the capacity */
+	enum Error error;
+	int errno_copy;
+};
+
+/* global errors for allocation */
+static enum Error global_error;
+static int        global_errno_copy;
+
+/* private prototypes */
+
+static struct Entry *probe(const struct Map *const m, const int key);
+static int grow(struct Map *const m);
+
+/* public */
+
+/** Constructs an empty map.
+ @return	An object.
+ @throws	call @see{MapError(0)} to see errors */
+struct Map *Map(void) {
+	struct Map *m;
+
+	if(!(m = malloc(sizeof(struct Map)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		return 0;
+	}
+	m->capacity   = initial_capacity;
+	m->size       = 0;
+	m->error      = E_NO_ERROR;
+	m->errno_copy = 0;
+	if(!(m->entries = calloc(m->capacity, sizeof(struct Entry)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		Map_(&m);
+		return 0;
+	}
+
+	return m;
+}
+
+/** Destructor.
+ @param m_ptr	A reference to the object that is to be deleted. */
+void Map_(struct Map **const m_ptr) {
+	struct Map *m;
+
+	if(!m_ptr || !(m = *m_ptr)) return;
+	free(m->entries);
+	free(m);
+	*m_ptr = 0;
+}
+
+/** @return	The number of keys. */
+int MapSize(const struct Map *const m) {
+	if(!m) return 0;
+	return m->size;
+}
+
+/** @return	A pointer to the value associated with key, which may be
+			modified, or null if the key is not in the map. It is valid
+			until the next @see{MapPut}. */
+int *MapGet(const struct Map *const m, const int key) {
+	struct Entry *e;
+
+	if(!m) return 0;
+	e = probe(m, key);
+	return e->is_used ? &e->value : 0;
+}
+
+/** Associates value with key, replacing the value if the key is there.
+ @return	Success.
+ @throws	!m; E_TOO_LARGE, E_ERRNO */
+int MapPut(struct Map *const m, const int key, const int value) {
+	struct Entry *e;
+
+	if(!m) return 0;
+	e = probe(m, key);
+	if(!e->is_used) {
+		if((m->size + 1) << 1 > m->capacity) {
+			if(!grow(m)) return 0;
+			e = probe(m, key);
+		}
+		e->is_used = -1;
+		e->key     = key;
+		m->size++;
+	}
+	e->value = value;
+	return -1;
+}
+
+/** Removes all the keys. */
+void MapClear(struct Map *const m) {
+	if(!m) return;
+	memset(m->entries, 0, sizeof(struct Entry) * m->capacity);
+	m->size = 0;
+}
+
+/** See what's the error if something goes wrong. The error is reset by this
+ action.
+ @param m	Map, or null for the constructor.
+ @return	The last error string.
+ @throws	!m, E_NO_ERR */
+char *MapError(struct Map *const m) {
+	char *str = 0;
+	enum Error *error_p;
+	int *errno_p;
+
+	error_p = m ? &m->error      : &global_error;
+	errno_p = m ? &m->errno_copy : &global_errno_copy;
+	switch(*error_p) {
+		case E_NO_ERROR:
+			break;
+		case E_ERRNO:
+			str = strerror(*errno_p);
+			*errno_p = 0;
+			break;
+		case E_TOO_LARGE:
+			str = "too large for index";
+			break;
+	}
+	*error_p = 0;
+	return str;
+}
+
+/* private */
+
+/** Fibonacci hashing; the ids are often consecutive.
+ @return	The entry for key, or the empty entry where it would go. */
+static struct Entry *probe(const struct Map *const m, const int key) {
+	const unsigned mask = (unsigned)m->capacity - 1;
+	unsigned i = ((unsigned)key * 2654435769u) & 0xffffffffu;
+	struct Entry *e;
+
+	for(i = (i ^ (i >> 16)) & mask; ; i = (i + 1) & mask) {
+		e = m->entries + i;
+		if(!e->is_used || e->key == key) return e;
+	}
+}
+
+/** Doubles the capacity and re-inserts everything. */
+static int grow(struct Map *const m) {
+	struct Entry *old = m->entries, *e, *f;
+	const int old_capacity = m->capacity;
+
+	if(m->capacity << 1 <= 0) { m->error = E_TOO_LARGE; return 0; }
+	if(!(e = calloc(m->capacity << 1, sizeof(struct Entry)))) {
+		m->error = E_ERRNO;
+		m->errno_copy = errno;
+		return 0;
+	}
+	m->entries   = e;
+	m->capacity <<= 1;
+	for(e = old; e < old + old_capacity; e++) {
+		if(!e->is_used) continue;
+		f = probe(m, e->key);
+		*f = *e;
+	}
+	free(old);
+
+	return -1;
+}
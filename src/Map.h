@@ -0,0 +1,11 @@
+struct Map;
+
+struct Map *Map(void);
+void Map_(struct Map **const m_ptr);
+int MapSize(const struct Map *const m);
+
+int *MapGet(const struct Map *const m, const int key);
+int MapPut(struct Map *const m, const int key, const int value);
+void MapClear(struct Map *const m);
+
+char *MapError(struct Map *const m);
@@ -0,0 +1,190 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* malloc free */
+#include <stdio.h>	/* FILE fwrite */
+#include <string.h>	/* memcpy strlen strerror */
+#include <errno.h>	/* global errno */
+#include "Out.h"
+
+/** Buffered output of strings and integers to a file. The caller owns the
+ buffer; it is only handed to the file when it is full, in one big write, so
+ there is no format string to interpret for every node and edge. Errors are
+ sticky: once a write fails, everything else is dropped and @see{Out_} and
+ @see{OutFlush} return false.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+enum Error {
+	E_NO_ERROR,
+	E_ERRNO,
+	E_PARAMETER
+};
+
+struct Out {
+	FILE *fp;
+	char *buffer;
+	size_t capacity;		/* of the buffer */
+	size_t size;			/* used of the buffer */
+	enum Error error;
+	int errno_copy;
+};
+
+/* global errors for allocation, and the last one of a writer that is gone */
+static enum Error global_error;
+static int        global_errno_copy;
+
+/* private prototypes */
+
+static void put(struct Out *const o, const char *const s, size_t size);
+
+/* public */
+
+/** Constructs a writer.
+ @param fp			Where the output goes.
+ @param buffer		A buffer that belongs to the caller and must last as long
+					as the Out.
+ @param capacity	The size of buffer; should be big, at least something like
+					64 KiB.
+ @return			An object.
+ @throws			call @see{OutError(0)} to see errors */
+struct Out *Out(FILE *const fp, char *const buffer, const size_t capacity) {
+	struct Out *o;
+
+	if(!fp || !buffer || capacity < 16) {
+		global_error = E_PARAMETER;
+		return 0;
+	}
+	if(!(o = malloc(sizeof(struct Out)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		return 0;
+	}
+	o->fp         = fp;
+	o->buffer     = buffer;
+	o->capacity   = capacity;
+	o->size       = 0;
+	o->error      = E_NO_ERROR;
+	o->errno_copy = 0;
+
+	return o;
+}
+
+/** Destructor; flushes whatever is left.
+ @param o_ptr	A reference to the object that is to be deleted.
+ @return		Whether all the output was written.
+ @throws		E_ERRNO; the object is gone, so it's in @see{OutError(0)} */
+int Out_(struct Out **const o_ptr) {
+	struct Out *o;
+	int is_ok;
+
+	if(!o_ptr || !(o = *o_ptr)) return -1;
+	if(!(is_ok = OutFlush(o))) {
+		global_error      = o->error;
+		global_errno_copy = o->errno_copy;
+	}
+	free(o);
+	*o_ptr = 0;
+	return is_ok;
+}
+
+/** Writes s. */
+void OutString(struct Out *const o, const char *const s) {
+	if(!o || !s) return;
+	put(o, s, strlen(s));
+}
+
+/** Writes c. */
+void OutChar(struct Out *const o, const char c) {
+	if(!o) return;
+	if(o->size >= o->capacity) put(o, &c, 1);
+	else o->buffer[o->size++] = c;
+}
+
+/** Writes i in decimal. */
+void OutInt(struct Out *const o, const int i) {
+	char digits[24], *d = digits + sizeof digits;
+	/* negating INT_MIN is undefined, so work in unsigned */
+	unsigned u = i < 0 ? 0u - (unsigned)i : (unsigned)i;
+
+	if(!o) return;
+	do { *--d = (char)('0' + u % 10); } while(u /= 10);
+	if(i < 0) *--d = '-';
+	put(o, d, (size_t)(digits + sizeof digits - d));
+}
+
+/** Writes the buffer to the file and the file to the system.
+ @return	Whether all the output so far was written.
+ @throws	E_ERRNO */
+int OutFlush(struct Out *const o) {
+	if(!o) return 0;
+	if(o->error) return 0;
+	if(o->size && fwrite(o->buffer, 1, o->size, o->fp) != o->size) {
+		o->error = E_ERRNO;
+		o->errno_copy = errno;
+		return 0;
+	}
+	o->size = 0;
+	if(fflush(o->fp) == EOF) {
+		o->error = E_ERRNO;
+		o->errno_copy = errno;
+		return 0;
+	}
+	return -1;
+}
+
+/** See what's the error if something goes wrong. The error is reset by this
+ action.
+ @param o	Out, or null for the constructor.
+ @return	The last error string.
+ @throws	!o, E_NO_ERR */
+char *OutError(struct Out *const o) {
+	char *str = 0;
+	enum Error *error_p;
+	int *errno_p;
+
+	error_p = o ? &o->error      : &global_error;
+	errno_p = o ? &o->errno_copy : &global_errno_copy;
+	switch(*error_p) {
+		case E_NO_ERROR:
+			break;
+		case E_ERRNO:
+			str = strerror(*errno_p);
+			*errno_p = 0;
+			break;
+		case E_PARAMETER:
+			str = "parameter out of range";
+			break;
+	}
+	*error_p = 0;
+	return str;
+}
+
+/* private */
+
+/** Copies size of s into the buffer, writing out the buffer whenever it
+ fills up. */
+static void put(struct Out *const o, const char *const s, size_t size) {
+	const char *from = s;
+	size_t room;
+
+	if(o->error) return;
+	while(size) {
+		if(o->size >= o->capacity) {
+			if(fwrite(o->buffer, 1, o->size, o->fp) != o->size) {
+				o->error = E_ERRNO;
+				o->errno_copy = errno;
+				return;
+			}
+			o->size = 0;
+		}
+		room = o->capacity - o->size;
+		if(room > size) room = size;
+		memcpy(o->buffer + o->size, from, room);
+		o->size += room;
+		from    += room;
+		size    -= room;
+	}
+}
@@ -0,0 +1,11 @@
+struct Out;
+
+struct Out *Out(FILE *const fp, char *const buffer, const size_t capacity);
+int Out_(struct Out **const o_ptr);
+
+void OutString(struct Out *const o, const char *const s);
+void OutChar(struct Out *const o, const char c);
+void OutInt(struct Out *const o, const int i);
+int OutFlush(struct Out *const o);
+
+char *OutError(struct Out *const o);
@@ -13,11 +13,30 @@
 #include <stdlib.h> /* malloc free strtol */
 #include <stdio.h>  /* fprintf */
 #include <string.h>	/* memcpy strcat */
-#include <limits.h>	/* strtol */
-#include <ctype.h>	/* isalpha */
+#include <limits.h>	/* INT_MAX UINT_MAX USHRT_MAX LONG_MAX */
+#include <ctype.h>	/* isalpha isspace */
 #include <stddef.h>	/* offsetof */
+#include <stdarg.h>	/* va_list */
+#include <errno.h>	/* errno ERANGE */
+#include <time.h>	/* clock */
+#include <pthread.h>
 #include "List.h"
+#include "Map.h"
+#include "BitSet.h"
+#include "Expr.h"
+#include "Tsv.h"
+#include "Out.h"
+#include "Work.h"
 #include "Penguin.h"
+#ifndef _WIN32 /* mmap */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>	/* gettimeofday */
+#include <sys/resource.h>	/* getrusage */
+#endif
 
 /* constants */
 
@@ -28,156 +47,225 @@ static const int versionMinor  = 1;
 
 /* globals */
 
-static struct Bit bits[100001]; /* EV Bible: max 10000 */
-static const int bits_size = sizeof bits / sizeof(struct Bit);
-
-static struct Misn misns[1000 + 128];
-static const int misns_size = sizeof misns / sizeof(struct Misn);
-
-static struct Cron crons[2048]; /* unsure of the bound -- I saw it somewhere */
-static const int crons_size = sizeof crons / sizeof(struct Cron);
+static struct Store bits;		/* struct Bit, in the order they are first seen */
+static const int bits_limit = 100001; /* EV Bible: max 10000 */
+
+static struct Store misns;		/* struct Misn */
+static struct Store crons;		/* struct Cron */
+static const int resource_min = 128; /* the first id of a resource */
+
+static struct ListArena *clusters; /* the lists of all the clusters */
+static struct MisnClusters *misn_clusters; /* [misns], until freeze */
+static struct CronClusters *cron_clusters; /* [crons], until freeze */
+
+static struct Graph graph;		/* the clusters, once they are parsed */
+
+static const char *cache_path;	/* -c, or null */
+static struct Cache cache;		/* what was in it */
+static const unsigned cache_version = 2;
+static const int cache_rewrite = 64; /* one in this many records changed */
+
+static int is_stream;			/* --stream */
+static int is_reach;			/* --reach */
+static int is_explore;			/* --explore */
+static int explore_depth = 16;	/* --explore-depth */
+static int explore_states = 100000; /* --explore-states */
+static const int shards_size = 256; /* a power of two */
+static const int explore_batch = 256; /* states a thread takes at once */
+static int simulate_years;		/* --simulate, or zero */
+static struct Date simulate_start = { 1177, 1, 16 }; /* --start */
+static int simulate_seed = 1;	/* --seed */
+static const char *focus_spec;	/* --focus, eg, "misn128,bit6666," or null */
+static int focus_depth = 2;		/* --depth */
+static int is_focus_forward = -1, is_focus_backward = -1; /* --direction */
+static struct BitSet *focus;	/* misns, crons, and then bits that are printed */
+static unsigned short *emptied;	/* [misns], lists the cull left empty, or null */
+static unsigned char *sorted_clusters; /* [misns], from merge_misns, or null */
+static const char *save_path;	/* --save-graph, or null */
+static const char *load_path;	/* --load-graph, or null */
+static const unsigned graph_version = 2;
+
+static int is_timing;			/* --timing */
+static const char *const stage_name[] = { "read", "freeze", "cull crons",
+	"cull out-degree", "merge", "emit", "analyse" };
+static double stage_wall[P_SIZE], stage_cpu[P_SIZE]; /* seconds */
+static int stage = P_SIZE;		/* the one that's running, or P_SIZE */
+static double stage_wall0, stage_cpu0;
+static struct Stats stats;
+static const char *stats_path;	/* --stats, or null */
+
+static char out_buffer[0x100000]; /* the GraphViz goes out in big writes */
+static struct Out *out;
+
+/* the fixed parts of the GraphViz output */
+static const char *const gv_not_bit  = " [color=red arrowhead=empty style=dashed];\n";
+static const char *const gv_not_misn = " [color=green arrowhead=empty style=dashed];\n";
+static const char *const gv_misn     = " [color=green];\n";
+static const char *const gv_end      = ";\n";
+
+static const char *const where_name[] = { "available", "accept", "refuse",
+	"success", "abort", "ship", "enable", "start", "end" };
 
 /* private prototypes */
 
-static int different(int *const a, int *const b);
-static int same(int *const a, int *const b);
-static int difference(int *const a, int *const b);
-static int list_contains_int(struct List *const l, const int i);
-static void print_int(const int *const pb);
-static void print_ints(struct List *const list);
-static void print_bit(struct Bit *const b);
-static void print_misn(struct Misn *const m);
-static void print_cron(struct Cron *const c);
-static void parse_resource(void *const reso, const struct Helper *const helper, const int helper_size);
-static void parse_bits(const char *const from, struct Cluster *const b, struct Cluster *const m, const size_t bit_misn_cluster, const int misn);
-static void cluster_add_bit(struct Cluster *const c, const int is_set, const int bit, const size_t bit_misn_cluster, const int misn);
+static int store(struct Store *const s, char *const name, const size_t width, const size_t id, const ListMetric compare);
+static void store_(struct Store *const s);
+static int store_size(const struct Store *const s);
+static void *store_at(const struct Store *const s, const int index);
+static void *store_get(const struct Store *const s, const int id);
+static void *store_put(struct Store *const s, const void *const reso);
+static void store_sort(struct Store *const s);
+static int bit_compare_id(const struct Bit *const a, const struct Bit *const b);
+static int misn_compare_id(const struct Misn *const a, const struct Misn *const b);
+static int cron_compare_id(const struct Cron *const a, const struct Cron *const b);
+static int parse_resources(void);
+static void parse_resource(const void *const reso, void *const cl, const struct Helper *const helper, const int helper_size);
+static void parse_bits(const char *const from, struct Cluster *const b, struct Cluster *const m);
+static struct Bit *bit_get(const int bit);
+static struct Bit *bit_touch(const int bit);
+static void cluster_add_bit(struct Cluster *const c, const int is_set, const int bit);
 static void cluster_add_misn(struct Cluster *const c, const int is_set, const int misn);
-static void delete_bit_from_misn(struct Misn *const misn, int bit);
-static void misn_sort_bits(struct Misn *const misn);
-static int misn_compare(const struct Misn *const a, const struct Misn *const b);
-
+static void *resource(const int r, const struct Helper **const phelper, int *const phelper_size);
+static int freeze(void);
+static void graph_(void);
+static int graph_save(void);
+static int graph_reverse(void);
+static int graph_load(void);
+static int graph_write(FILE *const fp, const char *const path, struct Hash *const sum);
+static int graph_map(char *const data, const size_t size, const char *const path);
+static int map_file(const char *const path, char **const pdata, size_t *const psize, int *const pis_mapped);
+static int graph_layout(struct GraphField *const layout);
+static int graph_strings_are_valid(const struct GraphField *const layout, const int layout_size, const enum Section section, const char *const records, const size_t width, const int size);
+static int adjacency_is_valid(const struct Adjacency *const a, const int vertices, const int bits_size, const int misns_size);
+static int input(char **const paths, const int paths_size, const int threads);
+static int adjacency(struct Adjacency *const a, const int vertices, const int edges);
+static void adjacency_(struct Adjacency *const a);
+static struct Edge *add_edges(struct Edge *e, struct List *const list, const enum Where where, const int flags);
+static int edge_compare(const struct Edge *const a, const struct Edge *const b);
+static int degree(const struct Adjacency *const a, const int v, const enum Where where, const int flags);
+static const struct Edge *first(const struct Adjacency *const a, const int v, const enum Where where, const int flags);
+static void cluster_bits(struct BitSet *const s, const int r, const enum Where where, const int flags);
+static unsigned misn_hash(const int m);
+static int misn_compare(const int m, const int n);
+static int misn_cluster_compare(const int m, const int n, int *const pequal);
+static unsigned misn_lists(const int m);
+static int misn_order(const int *const a, const int *const b);
+
+static int reach(void);
+static int tests(struct Tests *const t);
+static void tests_(struct Tests *const t);
+static int tests_map(const int bit, void *const param);
+static int explore(const int threads);
+static void explore_(struct Explorer *const x, const int threads);
+static void explore_task(struct Explorer *const x, const int worker, void *const item, struct WorkQueue *const q);
+static void explore_next(struct Explorer *const x, struct Explore *const t, struct WorkQueue *const q, const struct ExploreItem *const from, const int r, const enum Where where0, const enum Where where1);
+static int shard_add(struct Explorer *const x, struct Explore *const t, const struct ExploreItem *const item);
+static int shard_grow(struct Explorer *const x, struct Shard *const s);
+static int explorer_count(struct Explorer *const x, struct Explore *const t);
+static unsigned long random_next(unsigned long *const seed);
+static int simulate(void);
+static void simulate_(struct Simulator *const s);
+static void simulate_fire(struct Simulator *const s, const int c, const enum Where where);
+static void simulate_idle(struct Simulator *const s, const int c, const long day);
+static long simulate_window(const struct Simulator *const s, const struct Cron *const cron, long day);
+static void simulate_wake(struct Simulator *const s, const int c, const long day);
+static int simulate_before(const struct Simulator *const s, const int a, const int b);
+static int date_compare(const struct Date *const d, const int year, const int month, const int day);
+static void date_month(struct Date *const d);
+static long date_day(const struct Date *const d);
+static void day_date(const long day, struct Date *const d);
+static int date_days(const int year, const int month);
+static void out_date(const struct Date *const d);
+static int read_date(struct Date *const d, const char *field);
+static int focus_find(void);
+static int focus_vertex(const char *spec, const char **const pend);
+static void focus_visit(int *const depth, int *const queue, int *const ptail, const int v, const int u);
+static int graph_find(const char *const base, const struct Store *const s, const int size, const int key);
 static void cull_bits_reset_by_crons(void);
 static void cull_misns_out_degree_zero(void);
 static void merge_misns(void);
-static void print_edges(const int vertex, const struct Cluster *const bit, const struct Cluster *const misn, const char *const label, const char *const sub_label);
-static char *insert_scanf_useless_space(char *const str);
+static void merge_sorted(const int *const rep, int *const order);
+static void print_edges(const int r, const char *const label, const int vertex);
+static void print_edge_range(const struct Edge *e, const struct Edge *const end, const char *const label, const int vertex, const int is_raw);
+static int stream(char **const paths, const int paths_size);
+static void stream_resource(const void *const reso, void *const cl, const struct Helper *const helper, const int helper_size, const char *const label, const int id, struct List *const edges);
+static int loads_add(struct List *const loads, const char *const path, const int pieces);
+static int read_all(const char *const path, char **const ptext, size_t *const psize);
+static void sum_add(struct Hash *const sum, const void *const data, const size_t size);
+static void record_hash(struct Tsv *const tsv, struct Hash *const hash);
+static int load(struct Load *const l);
+static void load_(struct Load *const l);
+static void load_clear(struct Load *const l);
+static int cache_load(void);
+static void cache_(void);
+static int cache_get(const struct Hash *const hash);
+static int cache_lines_up(struct List *const loads, int *const pchanges);
+static int cache_patch(struct List *const loads);
+static int cache_patch_edges(struct List *const edges, const char *const cl, const struct Helper *const helper, const int helper_size);
+static int cache_fresh(struct List *const loads);
+static int cache_resolve(void);
+static int cache_save(void);
+static int load_all(struct List *const loads, const int threads);
+static void load_work(struct Load *const loads, const int job);
+static void load_decode(struct Load *const l, struct Tsv *const tsv);
+static int decode(struct Load *const l, struct Tsv *const tsv, struct Misn *const m, struct Cron *const c);
+static int load_commit(struct Load *const l, const int is_store);
+static void note(struct Load *const l, const char *const format, ...);
+static int read_record(void *const reso, const struct Field *const fields, const int fields_size, struct Tsv *const tsv, struct Load *const l);
+static int read_int(int *const i, const char *field);
+static int read_hex(unsigned *const u, const char *field);
+static void read_string(char *const string, const size_t size, const char *const field);
+static int is_blank(const char *s);
 static void escape(char *const string);
+static void stage_start(const enum Stage s);
+static void clocks(double *const wall, double *const cpu);
+static long peak_resident(void);
+static void timing_print(void);
+static int stats_print(void);
 static void usage(void);
 
 /* functions */
 
-/** Contains in list? @see{list_contains_int}
- @implements	ListPredicate */
-static int different(int *const a, int *const b) {
-	return *a != *b;
-}
-
-/** @implements	ListPredicate */
-static int same(int *const a, int *const b) {
-	return *a == *b;
-}
-
-/** @implements ListMetric */
-static int difference(int *const a, int *const b) {
-	return *a - *b;
-}
-
-/** Only call it on int lists! */
-static int list_contains_int(struct List *const l, const int i) {
-	return !ListShortCircuit(l, (ListPredicate)&different, (int *)&i);
-}
-
-/** See @see{print_bits}.
- @implements	ListAction */
-static void print_int(const int *const pb) { fprintf(stderr, " %d", *pb); }
-
-/** Prints list<int> on stderr. */
-static void print_ints(struct List *const list) {
-	if(!list) {
-		fprintf(stderr, "0");
-		return;
-	}
-	fprintf(stderr, "[");
-	ListForEach(list, (ListAction)&print_int);
-	fprintf(stderr, " ]");
-}
-
-static void print_cluster(struct Cluster *const cluster) {
-	fprintf(stderr, "<");
-	print_ints(cluster->set);
-	fprintf(stderr, ",!");
-	print_ints(cluster->clear);
-	fprintf(stderr, ">");
-}
-
-static void print_bit(struct Bit *const b) {
-	const struct Helper *help;
+/** Builds the clusters of every misn and cron once all have been read, so a
+ resource that is replaced by a later one with the same id leaves nothing
+ behind. They are in the order of the stores.
+ @return	Success. */
+static int parse_resources(void) {
+	const int misns_size = store_size(&misns), crons_size = store_size(&crons);
 	int i;
 
-	if(!b) {
-		fprintf(stderr, "<null>\n");
-		return;
-	}
-	fprintf(stderr, "Bit%d is %s\n", b->bit, b->is_used ? "used" : "not used");
-	if(!b->is_used) return;
-	for(i = 0; i < misn_helper_size; i++) {
-		help = misn_helper + i;
-		fprintf(stderr, "\t%s: ", help->name);
-		print_cluster((struct Cluster *)((char *)b + help->bit_resource_cluster));
-		fprintf(stderr, "\n");
+	misn_clusters = calloc(misns_size ? misns_size : 1, sizeof *misn_clusters);
+	cron_clusters = calloc(crons_size ? crons_size : 1, sizeof *cron_clusters);
+	if(!misn_clusters || !cron_clusters) {
+		perror("Parse");
+		free(misn_clusters);
+		free(cron_clusters);
+		misn_clusters = 0;
+		cron_clusters = 0;
+		return 0;
 	}
-}
-
-static void print_misn(struct Misn *const m) {
-	const struct Helper *help;
-	int i;
-
-	if(!m) {
-		fprintf(stderr, "<null>\n");
-		return;
+	for(i = 0; i < misns_size; i++) {
+		parse_resource(store_at(&misns, i), misn_clusters + i, misn_helper, misn_helper_size);
 	}
-	fprintf(stderr, "Misn%d:<%s> is %s\n", m->id, m->name, m->is_used ? "used" : "not used");
-	if(!m->is_used) return;
-	for(i = 0; i < misn_helper_size; i++) {
-		help = misn_helper + i;
-		fprintf(stderr, "\t%s: ", help->name);
-		print_cluster((struct Cluster *)((char *)m + help->bit_cluster));
-		fprintf(stderr, "\n");
+	for(i = 0; i < crons_size; i++) {
+		parse_resource(store_at(&crons, i), cron_clusters + i, cron_helper, cron_helper_size);
 	}
+	return -1;
 }
 
-static void print_cron(struct Cron *const c) {
-	const struct Helper *help;
+/** This parses the bits of reso that are in the Helper into cl, which is its
+ MisnClusters or CronClusters. */
+static void parse_resource(const void *const reso, void *const cl, const struct Helper *const helper, const int helper_size) {
 	int i;
 
-	if(!c) {
-		fprintf(stderr, "<null>\n");
-		return;
-	}
-	fprintf(stderr, "Cron%d is %s\n", c->id, c->is_used ? "used" : "not used");
-	if(!c->is_used) return;
-	for(i = 0; i < cron_helper_size; i++) {
-		help = cron_helper + i;
-		fprintf(stderr, "\t%s: ", help->name);
-		print_cluster((struct Cluster *)((char *)c + help->bit_cluster));
-		fprintf(stderr, "\n");
-	}
-}
-
-/** This parses the bits that are in the Helper. */
-static void parse_resource(void *const reso, const struct Helper *const helper, const int helper_size) {
-	int i, misn = (struct Misn *)reso - misns;
-
-	if(misn < 0 || misn > misns_size) misn = 0;
-	for(i = 0; i < helper_size; i++) parse_bits((char *)reso + helper[i].raw,
-		(struct Cluster *)((char *)reso + helper[i].bit_cluster),
+	for(i = 0; i < helper_size; i++) parse_bits((const char *)reso + helper[i].raw,
+		(struct Cluster *)((char *)cl + helper[i].bit_cluster),
 		helper[i].misn_cluster ?
-			(struct Cluster *)((char *)reso + helper[i].misn_cluster) : 0,
-		helper[i].bit_resource_cluster, misn);
+			(struct Cluster *)((char *)cl + helper[i].misn_cluster) : 0);
 }
 
 /** Parse from and stick in into b and m. */
-static void parse_bits(const char *const from, struct Cluster *const b, struct Cluster *const m, const size_t bit_resource_cluster, const int misn) {
+static void parse_bits(const char *const from, struct Cluster *const b, struct Cluster *const m) {
 	int is_invert[16], is_invert_top = 0, is_invert_current, is_note = 0;
 	const int is_invert_capacity = sizeof is_invert / sizeof(int);
 	int is_invert_size = 0;
@@ -213,11 +301,11 @@ static void parse_bits(const char *const from, struct Cluster *const b, struct C
 			case 'B':
 				/* k is the misn bit that we parse */
 				k = strtol(f + 1, &f, 0); f--;
-				if(k < 0 || k >= bits_size) return;
+				if(k < 0 || k >= bits_limit) return;
 				is_invert_current = is_invert_top ^ (is_invert_size ? is_invert[is_invert_size - 1] : 0);
 				/*fprintf(stderr, "<%s> %ld:%s\n", from, k, is_invert_current ? "invert" : "normal");*/
 				/*if(!predicate || predicate(k, !is_invert_current, flags)) {*/
-				cluster_add_bit(b, !is_invert_current, k, bit_resource_cluster, misn);
+				cluster_add_bit(b, !is_invert_current, k);
 				is_invert_top = 0;
 				break;
 			case 'a': /* abort */
@@ -268,160 +356,894 @@ static void parse_bits(const char *const from, struct Cluster *const b, struct C
 	if(is_note) fprintf(stderr, "Warning: I don't entirely understand, \"%s.\"\n", from);
 }
 
-static void cluster_add_bit(struct Cluster *const c, const int is_set, const int bit, const size_t bit_resource_cluster, const int misn) {
+/** Initialises a Store.
+ @return	Success. */
+static int store(struct Store *const s, char *const name, const size_t width, const size_t id, const ListMetric compare) {
+	s->name    = name;
+	s->width   = width;
+	s->id      = id;
+	s->compare = compare;
+	s->list    = List(width);
+	s->index   = Map();
+	if(!s->list || !s->index) {
+		fprintf(stderr, "%s: %s.\n", name, s->list ? MapError(0) : ListError(0));
+		store_(s);
+		return 0;
+	}
+	return -1;
+}
+
+static void store_(struct Store *const s) {
+	List_(&s->list);
+	Map_(&s->index);
+}
+
+static int store_size(const struct Store *const s) {
+	return ListSize(s->list);
+}
+
+/** @return	The resource at index in [0, store_size). */
+static void *store_at(const struct Store *const s, const int index) {
+	return ListGet(s->list, index);
+}
+
+/** @return	The resource that has id, or null. */
+static void *store_get(const struct Store *const s, const int id) {
+	int *pindex;
+
+	if(!(pindex = MapGet(s->index, id))) return 0;
+	return ListGet(s->list, *pindex);
+}
+
+/** Copies reso into the store; if there is already one with the same id, it is
+ replaced.
+ @return	The copy, valid until the next put, or null on error. */
+static void *store_put(struct Store *const s, const void *const reso) {
+	const int id = *(int *)((char *)reso + s->id);
+	void *copy;
+	char *e;
+
+	if((copy = store_get(s, id))) {
+		fprintf(stderr, "%s%d replaces an earlier one.\n", s->name, id);
+		memcpy(copy, reso, s->width);
+		return copy;
+	}
+	if(!ListAdd(s->list, reso) || !MapPut(s->index, id, ListSize(s->list) - 1)) {
+		if((e = ListError(s->list)) || (e = MapError(s->index))) fprintf(stderr, "%s%d: %s.\n", s->name, id, e);
+		return 0;
+	}
+	return ListGet(s->list, ListSize(s->list) - 1);
+}
+
+/** Sorts the store by id. */
+static void store_sort(struct Store *const s) {
+	char *reso;
+	int i;
+
+	if(ListIsSorted(s->list, s->compare)) return;
+	ListSort(s->list, s->compare);
+	for(i = 0; (reso = ListGet(s->list, i)); i++) {
+		MapPut(s->index, *(int *)(reso + s->id), i);
+	}
+}
+
+/** @implements	ListMetric */
+static int bit_compare_id(const struct Bit *const a, const struct Bit *const b) {
+	return (a->bit > b->bit) - (a->bit < b->bit);
+}
+
+/** @implements	ListMetric */
+static int misn_compare_id(const struct Misn *const a, const struct Misn *const b) {
+	return (a->id > b->id) - (a->id < b->id);
+}
+
+/** @implements	ListMetric */
+static int cron_compare_id(const struct Cron *const a, const struct Cron *const b) {
+	return (a->id > b->id) - (a->id < b->id);
+}
+
+/** @return	The bit, or null if it's not been seen. */
+static struct Bit *bit_get(const int bit) {
+	return store_get(&bits, bit);
+}
+
+/** Adds the bit if it's not been seen.
+ @return	The bit, valid until the next bit is added, or null on error. */
+static struct Bit *bit_touch(const int bit) {
+	struct Bit b, *pb;
+
+	if((pb = bit_get(bit))) return pb;
+	memset(&b, 0, sizeof b);
+	b.bit = bit;
+	return store_put(&bits, &b);
+}
+
+static void cluster_add_bit(struct Cluster *const c, const int is_set, const int bit) {
 	/* pointer to the list of bits of the misn, set or clear */
 	struct List **const ppm = is_set ? &c->set : &c->clear;
-	/* select bit_misn_cluster from bits[bit] */
-	struct Cluster *const bit_misn = (struct Cluster *)((char *)(bits + bit) + bit_resource_cluster);
-	/* pointer to the list of misns of the bit, set or clear */
-	struct List **const ppb = is_set ? &bit_misn->set : &bit_misn->clear;
+	struct Bit *b;
 
-	if(bit < 0 || bit > bits_size) {
-		fprintf(stderr, "Warning: %d is outside the range [0, %d).\n", bit, bits_size);
+	if(bit < 0 || bit >= bits_limit) {
+		fprintf(stderr, "Warning: %d is outside the range [0, %d).\n", bit, bits_limit);
 		return;
 	}
-	bits[bit].is_used = -1;
-	bits[bit].bit     = bit;
-	if(!*ppm) *ppm = List(sizeof(int));
+	if(!(b = bit_touch(bit))) return;
+	b->is_used = -1;
+	if(!*ppm) *ppm = ListIn(clusters, sizeof(int));
 	ListAdd(*ppm, &bit);
-	/* now add it in the Bit, as well */
-	if(!*ppb) *ppb = List(sizeof(int));
-	ListAdd(*ppb, &misn);
 }
 
 static void cluster_add_misn(struct Cluster *const c, const int is_set, const int misn) {
 	struct List **ppm = is_set ? &c->set : &c->clear;
 
-	if(misn < 0 || misn > misns_size) {
-		fprintf(stderr, "Warning: %d is outside the range [0, %d).\n", misn, misns_size);
+	if(misn < resource_min) {
+		fprintf(stderr, "Warning: misn %d is less than %d.\n", misn, resource_min);
 		return;
 	}
-	if(!*ppm) *ppm = List(sizeof(int));
+	if(!*ppm) *ppm = ListIn(clusters, sizeof(int));
 	ListAdd(*ppm, &misn);
 }
 
-static void delete_bit_from_misn(struct Misn *const misn, int bit) {
+/** @return	Resource r, where the misns are first, then the crons, and its
+			helper. */
+static void *resource(const int r, const struct Helper **const phelper, int *const phelper_size) {
+	if(r < graph.misns_size) {
+		*phelper = misn_helper;
+		*phelper_size = misn_helper_size;
+		return graph.misns + r;
+	}
+	*phelper = cron_helper;
+	*phelper_size = cron_helper_size;
+	return graph.crons + r - graph.misns_size;
+}
+
+/** Packs the clusters into the graph and frees them; everything after works
+ on the graph. The bits are sorted first, so indices are in the order of the
+ ids, like the misns and crons. The forward edges of a resource are sorted by
+ @see{edge_compare}; the reverse edges of a bit are in the order of the
+ resources.
+ @return	Success. */
+static int freeze(void) {
+	const struct Helper *helper;
 	struct Cluster *cluster;
-	int no = 0, i;
+	struct Edge *e, *f;
+	char *cl;
+	int helper_size, vertices, no = 0, r, i;
+
+	store_sort(&bits);
+	graph.misns      = store_at(&misns, 0);
+	graph.crons      = store_at(&crons, 0);
+	graph.bits       = store_at(&bits, 0);
+	graph.misns_size = store_size(&misns);
+	graph.crons_size = store_size(&crons);
+	graph.bits_size  = store_size(&bits);
+	vertices = graph.misns_size + graph.crons_size;
+
+	/* count so we can allocate once */
+	for(r = 0; r < vertices; r++) {
+		resource(r, &helper, &helper_size);
+		cl = r < graph.misns_size ? (char *)(misn_clusters + r)
+			: (char *)(cron_clusters + r - graph.misns_size);
+		for(i = 0; i < helper_size; i++) {
+			cluster = (struct Cluster *)(cl + helper[i].bit_cluster);
+			no += ListSize(cluster->set) + ListSize(cluster->clear);
+			if(!helper[i].misn_cluster) continue;
+			cluster = (struct Cluster *)(cl + helper[i].misn_cluster);
+			no += ListSize(cluster->set) + ListSize(cluster->clear);
+		}
+	}
+	if(!adjacency(&graph.forward, vertices, no)) return 0;
+
+	/* forward */
+	for(e = graph.forward.edges, r = 0; r < vertices; r++) {
+		graph.forward.start[r] = e - graph.forward.edges;
+		resource(r, &helper, &helper_size);
+		cl = r < graph.misns_size ? (char *)(misn_clusters + r)
+			: (char *)(cron_clusters + r - graph.misns_size);
+		for(i = 0; i < helper_size; i++) {
+			cluster = (struct Cluster *)(cl + helper[i].bit_cluster);
+			e = add_edges(e, cluster->set, helper[i].where, E_SET);
+			e = add_edges(e, cluster->clear, helper[i].where, 0);
+			if(!helper[i].misn_cluster) continue;
+			cluster = (struct Cluster *)(cl + helper[i].misn_cluster);
+			e = add_edges(e, cluster->set, helper[i].where, E_MISN | E_SET);
+			e = add_edges(e, cluster->clear, helper[i].where, E_MISN);
+		}
+		f = graph.forward.edges + graph.forward.start[r];
+		/* a bit that is in a test twice stays twice; it was printed and
+		 compared that way */
+		qsort(f, e - f, sizeof *f, (ListMetric)&edge_compare);
+		graph.forward.end[r] = e - graph.forward.edges;
+	}
+	ListArena_(&clusters);
+	free(misn_clusters);
+	misn_clusters = 0;
+	free(cron_clusters);
+	cron_clusters = 0;
+
+	return graph_reverse();
+}
+
+/** Builds the reverse edges from the forward edges of the graph; the edges
+ of a bit are in the order of the resources.
+ @return	Success. */
+static int graph_reverse(void) {
+	const int vertices = graph.misns_size + graph.crons_size;
+	struct Edge *e, *f;
+	int no, r, b, i;
+
+	/* reverse: count the in-degree of the bits, then fill them in order */
+	for(no = 0, r = 0; r < vertices; r++) {
+		for(e = graph.forward.edges + graph.forward.start[r]; e < graph.forward.edges + graph.forward.end[r]; e++) {
+			if(!(e->flags & E_MISN)) no++;
+		}
+	}
+	if(!adjacency(&graph.reverse, graph.bits_size, no)) return 0;
+	for(b = 0; b < graph.bits_size; b++) graph.reverse.start[b] = 0;
+	for(r = 0; r < vertices; r++) {
+		for(e = graph.forward.edges + graph.forward.start[r]; e < graph.forward.edges + graph.forward.end[r]; e++) {
+			if(!(e->flags & E_MISN)) graph.reverse.start[e->to]++;
+		}
+	}
+	for(no = 0, b = 0; b < graph.bits_size; b++) {
+		i = graph.reverse.start[b];
+		graph.reverse.start[b] = graph.reverse.end[b] = no;
+		no += i;
+	}
+	for(r = 0; r < vertices; r++) {
+		for(e = graph.forward.edges + graph.forward.start[r]; e < graph.forward.edges + graph.forward.end[r]; e++) {
+			if((e->flags & E_MISN)) continue;
+			f = graph.reverse.edges + graph.reverse.end[e->to]++;
+			f->to    = r;
+			f->where = e->where;
+			f->flags = e->flags;
+			f->rank  = 0;
+		}
+	}
+
+	return -1;
+}
 
-	if(!misn->is_used) return;
-	for(i = 0; i < misn_helper_size; i++) {
-		cluster = (struct Cluster *)((char *)misn + misn_helper[i].bit_cluster);
-		no += ListRemoveIf(cluster->set, (ListPredicate)&same, &bit);
-		no += ListRemoveIf(cluster->clear, (ListPredicate)&same, &bit);
+static void graph_(void) {
+	free(emptied);
+	emptied = 0;
+	free(sorted_clusters);
+	sorted_clusters = 0;
+	if(!graph.snapshot || graph.is_patched) {
+		adjacency_(&graph.forward);
+		adjacency_(&graph.reverse);
 	}
-	/*if(no) fprintf(stderr, "removed %d b%d from Misn%d.\n", no, bit, misn->id);*/
+	if(graph.is_patched) free(graph.bits);
+	if(!graph.snapshot) return;
+#ifndef _WIN32
+	if(graph.is_mapped) munmap(graph.snapshot, graph.snapshot_size);
+	else
+#endif
+	free(graph.snapshot);
+	memset(&graph, 0, sizeof graph);
 }
 
-/* unused */
-static void misn_sort_bits(struct Misn *const misn) {
-	struct Cluster *cluster;
+/** Writes the graph to save_path.
+ @return	Success. */
+static int graph_save(void) {
+	FILE *fp;
+	int is_ok;
+
+	if(!(fp = fopen(save_path, "wb"))) {
+		fprintf(stderr, "%s: %s.\n", save_path, strerror(errno));
+		return 0;
+	}
+	is_ok = graph_write(fp, save_path, 0);
+	if(fclose(fp) == EOF) is_ok = 0;
+	if(!is_ok) fprintf(stderr, "%s: %s.\n", save_path, strerror(errno));
+	return is_ok;
+}
+
+/** Writes the graph to fp, which is at an offset that's a multiple of eight.
+ @param path	For the messages.
+ @param sum		If not null, what's written is added to it with @see{sum_add}.
+ @return		Success; if it's a write error, it's not printed. */
+static int graph_write(FILE *const fp, const char *const path, struct Hash *const sum) {
+	struct GraphHeader head;
+	struct GraphField *layout;
+	const char zero[8] = { 0 };
+	const void *section[S_SIZE];
+	unsigned long offset, size[S_SIZE];
+	int s, layout_size, is_ok = -1;
+
+	if(sizeof(int) != 4) {
+		fprintf(stderr, "%s: a graph has 32-bit ints.\n", path);
+		return 0;
+	}
+	layout_size = graph_layout(0);
+	if(!(layout = malloc(sizeof *layout * layout_size))) {
+		fprintf(stderr, "%s: %s.\n", path, strerror(errno));
+		return 0;
+	}
+	graph_layout(layout);
+	memset(&head, 0, sizeof head);
+	memcpy(head.magic, "PngG", sizeof head.magic);
+	head.version      = graph_version;
+	head.endian       = 0x01020304;
+	head.misn_width   = sizeof(struct Misn);
+	head.cron_width   = sizeof(struct Cron);
+	head.bit_width    = sizeof(struct Bit);
+	head.edge_width   = sizeof(struct Edge);
+	head.misns_size   = graph.misns_size;
+	head.crons_size   = graph.crons_size;
+	head.bits_size    = graph.bits_size;
+	head.forward_size = graph.forward.edges_size;
+	head.reverse_size = graph.reverse.edges_size;
+	section[S_LAYOUT]        = layout;
+	size[S_LAYOUT]           = sizeof *layout * layout_size;
+	section[S_MISNS]         = graph.misns;
+	size[S_MISNS]            = sizeof(struct Misn) * graph.misns_size;
+	section[S_CRONS]         = graph.crons;
+	size[S_CRONS]            = sizeof(struct Cron) * graph.crons_size;
+	section[S_BITS]          = graph.bits;
+	size[S_BITS]             = sizeof(struct Bit) * graph.bits_size;
+	section[S_FORWARD_START] = graph.forward.start;
+	section[S_FORWARD_END]   = graph.forward.end;
+	size[S_FORWARD_START] = size[S_FORWARD_END]
+		= sizeof(int) * (graph.misns_size + graph.crons_size);
+	section[S_FORWARD_EDGES] = graph.forward.edges;
+	size[S_FORWARD_EDGES]    = sizeof(struct Edge) * graph.forward.edges_size;
+	section[S_REVERSE_START] = graph.reverse.start;
+	section[S_REVERSE_END]   = graph.reverse.end;
+	size[S_REVERSE_START] = size[S_REVERSE_END]
+		= sizeof(int) * graph.bits_size;
+	section[S_REVERSE_EDGES] = graph.reverse.edges;
+	size[S_REVERSE_EDGES]    = sizeof(struct Edge) * graph.reverse.edges_size;
+	/* every section is aligned to eight, and they all fit in 32 bits */
+	for(offset = (sizeof head + 7) & ~7ul, s = 0; s < S_SIZE; s++) {
+		head.offset[s] = offset;
+		head.size[s]   = size[s];
+		offset = (offset + size[s] + 7) & ~7ul;
+	}
+	if(offset > 0xffffffffu) {
+		fprintf(stderr, "%s: the graph is too big to save.\n", path);
+		free(layout);
+		return 0;
+	}
+
+	fwrite(&head, sizeof head, 1, fp);
+	if(sum) sum_add(sum, &head, sizeof head);
+	for(offset = sizeof head, s = 0; s < S_SIZE; s++) {
+		fwrite(zero, head.offset[s] - offset, 1, fp);
+		if(size[s]) fwrite(section[s], size[s], 1, fp);
+		if(sum) {
+			sum_add(sum, zero, head.offset[s] - offset);
+			sum_add(sum, section[s], size[s]);
+		}
+		offset = head.offset[s] + size[s];
+	}
+	free(layout);
+	if(ferror(fp)) is_ok = 0;
+	return is_ok;
+}
+
+/** Maps the file at load_path, which was written by @see{graph_save}, and
+ points the graph into it. It is mapped privately, so the culls can change it
+ without changing the file.
+ @return	Success. */
+static int graph_load(void) {
+	if(!map_file(load_path, &graph.snapshot, &graph.snapshot_size, &graph.is_mapped)) {
+		fprintf(stderr, "%s: %s.\n", load_path, strerror(errno));
+		return 0;
+	}
+	return graph_map(graph.snapshot, graph.snapshot_size, load_path);
+}
+
+/** Maps all of the file at path privately, so it can be written to without
+ changing the file, or reads it if it can't be mapped.
+ @param pis_mapped	Gets whether it's to be unmapped instead of freed.
+ @return			Success.
+ @throws			errno; nothing is printed. */
+static int map_file(const char *const path, char **const pdata, size_t *const psize, int *const pis_mapped) {
+	char *data = 0;
+	size_t size = 0;
+
+	*pis_mapped = 0;
+#ifndef _WIN32
+	{
+		struct stat st;
+		int fd;
+		if((fd = open(path, O_RDONLY)) == -1) return 0;
+		if(fstat(fd, &st) == -1) { close(fd); return 0; }
+		size = (size_t)st.st_size;
+		if(size && (data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)) == MAP_FAILED) data = 0;
+		close(fd);
+		if(data) *pis_mapped = -1;
+	}
+#endif
+	if(!data && !read_all(path, &data, &size)) return 0;
+	*pdata = data;
+	*psize = size;
+	return -1;
+}
+
+/** Points the graph into data, which is size bytes that were written by
+ @see{graph_write} at an address that's a multiple of eight, once it's made
+ sure that nothing in it can be read out of bounds.
+ @param path	For the messages.
+ @return		Success. */
+static int graph_map(char *const data, const size_t size, const char *const path) {
+	struct GraphHeader head;
+	struct GraphField *layout;
+	int s, layout_size, is_ok;
+
+	if(size < sizeof head) {
+		fprintf(stderr, "%s: not a graph.\n", path);
+		return 0;
+	}
+	memcpy(&head, data, sizeof head);
+	if(memcmp(head.magic, "PngG", sizeof head.magic)
+		|| head.version != graph_version || head.endian != 0x01020304
+		|| head.misn_width != sizeof(struct Misn)
+		|| head.cron_width != sizeof(struct Cron)
+		|| head.bit_width != sizeof(struct Bit)
+		|| head.edge_width != sizeof(struct Edge)) {
+		fprintf(stderr, "%s: not a graph from this version.\n", path);
+		return 0;
+	}
+	for(s = 0; s < S_SIZE; s++) {
+		if(head.offset[s] > size || head.size[s] > size - head.offset[s]
+			|| head.offset[s] & 7) {
+			fprintf(stderr, "%s: truncated.\n", path);
+			return 0;
+		}
+	}
+	/* the records are only mapped if they are where this build has them */
+	layout_size = graph_layout(0);
+	if(!(layout = malloc(sizeof *layout * layout_size))) {
+		fprintf(stderr, "%s: %s.\n", path, strerror(errno));
+		return 0;
+	}
+	graph_layout(layout);
+	is_ok = head.size[S_LAYOUT] == sizeof *layout * layout_size
+		&& !memcmp(data + head.offset[S_LAYOUT], layout, head.size[S_LAYOUT]);
+	if(!is_ok) {
+		fprintf(stderr, "%s: the records are laid out differently than in this build.\n", path);
+		free(layout);
+		return 0;
+	}
+	if(head.misns_size < 0 || head.crons_size < 0 || head.bits_size < 0
+		|| head.forward_size < 0 || head.reverse_size < 0) {
+		fprintf(stderr, "%s: the sections are the wrong size.\n", path);
+		free(layout);
+		return 0;
+	}
+	graph.misns_size          = head.misns_size;
+	graph.crons_size          = head.crons_size;
+	graph.bits_size           = head.bits_size;
+	graph.forward.edges_size  = head.forward_size;
+	graph.reverse.edges_size  = head.reverse_size;
+	graph.misns         = (struct Misn *)(data + head.offset[S_MISNS]);
+	graph.crons         = (struct Cron *)(data + head.offset[S_CRONS]);
+	graph.bits          = (struct Bit *)(data + head.offset[S_BITS]);
+	graph.forward.start = (int *)(data + head.offset[S_FORWARD_START]);
+	graph.forward.end   = (int *)(data + head.offset[S_FORWARD_END]);
+	graph.forward.edges = (struct Edge *)(data + head.offset[S_FORWARD_EDGES]);
+	graph.reverse.start = (int *)(data + head.offset[S_REVERSE_START]);
+	graph.reverse.end   = (int *)(data + head.offset[S_REVERSE_END]);
+	graph.reverse.edges = (struct Edge *)(data + head.offset[S_REVERSE_EDGES]);
+	if(head.size[S_MISNS] != sizeof(struct Misn) * graph.misns_size
+		|| head.size[S_CRONS] != sizeof(struct Cron) * graph.crons_size
+		|| head.size[S_BITS] != sizeof(struct Bit) * graph.bits_size
+		|| head.size[S_FORWARD_START] != sizeof(int) * (graph.misns_size + graph.crons_size)
+		|| head.size[S_FORWARD_END] != head.size[S_FORWARD_START]
+		|| head.size[S_FORWARD_EDGES] != sizeof(struct Edge) * graph.forward.edges_size
+		|| head.size[S_REVERSE_START] != sizeof(int) * graph.bits_size
+		|| head.size[S_REVERSE_END] != head.size[S_REVERSE_START]
+		|| head.size[S_REVERSE_EDGES] != sizeof(struct Edge) * graph.reverse.edges_size) {
+		fprintf(stderr, "%s: the sections are the wrong size.\n", path);
+		free(layout);
+		return 0;
+	}
+	/* everything after this indexes with them and prints them without looking */
+	if(!adjacency_is_valid(&graph.forward, graph.misns_size + graph.crons_size, graph.bits_size, graph.misns_size)
+		|| !adjacency_is_valid(&graph.reverse, graph.bits_size, graph.misns_size + graph.crons_size, 0)) {
+		fprintf(stderr, "%s: the edges are out of range.\n", path);
+		free(layout);
+		return 0;
+	}
+	if(!graph_strings_are_valid(layout, layout_size, S_MISNS, (char *)graph.misns, sizeof *graph.misns, graph.misns_size)
+		|| !graph_strings_are_valid(layout, layout_size, S_CRONS, (char *)graph.crons, sizeof *graph.crons, graph.crons_size)) {
+		fprintf(stderr, "%s: a string is not terminated.\n", path);
+		free(layout);
+		return 0;
+	}
+	free(layout);
+	return -1;
+}
+
+/** Puts where every field of the records is in layout, if it's not null; a
+ field goes up to the next one.
+ @return	The number of fields. */
+static int graph_layout(struct GraphField *const layout) {
+	static const struct {
+		enum Section section;
+		size_t width;
+		const struct Field *fields;
+		int fields_size;
+	} parts[] = {
+		{ S_MISNS, sizeof(struct Misn), misn_used_field, sizeof misn_used_field / sizeof(struct Field) },
+		{ S_MISNS, sizeof(struct Misn), misn_fields, sizeof misn_fields / sizeof(struct Field) },
+		{ S_CRONS, sizeof(struct Cron), cron_used_field, sizeof cron_used_field / sizeof(struct Field) },
+		{ S_CRONS, sizeof(struct Cron), cron_fields, sizeof cron_fields / sizeof(struct Field) },
+		{ S_BITS, sizeof(struct Bit), bit_fields, sizeof bit_fields / sizeof(struct Field) },
+		{ S_FORWARD_EDGES, sizeof(struct Edge), edge_fields, sizeof edge_fields / sizeof(struct Field) }
+	};
+	const int parts_size = sizeof parts / sizeof *parts;
+	struct GraphField *g;
+	size_t end;
+	int p, q, i, j, no = 0;
+
+	for(p = 0; p < parts_size; p++) {
+		if(!layout) { no += parts[p].fields_size; continue; }
+		for(i = 0; i < parts[p].fields_size; i++) {
+			/* the next field in memory, or the end of the record */
+			end = parts[p].width;
+			for(q = 0; q < parts_size; q++) {
+				if(parts[q].section != parts[p].section) continue;
+				for(j = 0; j < parts[q].fields_size; j++) {
+					if(parts[q].fields[j].offset > parts[p].fields[i].offset
+						&& parts[q].fields[j].offset < end) end = parts[q].fields[j].offset;
+				}
+			}
+			g = layout + no++;
+			memset(g, 0, sizeof *g);
+			strncpy(g->name, parts[p].fields[i].name, sizeof g->name - 1);
+			g->section = parts[p].section;
+			g->format  = parts[p].fields[i].format;
+			g->offset  = (unsigned)parts[p].fields[i].offset;
+			g->width   = (unsigned)(end - parts[p].fields[i].offset);
+		}
+	}
+	return no;
+}
+
+/** @return	Whether every string in layout of section has a null in it in all
+			size records, which are width apart. */
+static int graph_strings_are_valid(const struct GraphField *const layout, const int layout_size, const enum Section section, const char *const records, const size_t width, const int size) {
+	const char *r;
 	int i;
-	
-	if(!misn->is_used) return;
-	for(i = 0; i < misn_helper_size; i++) {
-		cluster = (struct Cluster *)((char *)misn + misn_helper[i].bit_cluster);
-		ListSort(cluster->set, (ListMetric)&difference);
-		ListSort(cluster->clear, (ListMetric)&difference);
+
+	for(i = 0; i < layout_size; i++) {
+		if(layout[i].section != (unsigned)section || layout[i].format != F_STRING) continue;
+		for(r = records; r < records + width * size; r += width) {
+			if(!memchr(r + layout[i].offset, '\0', layout[i].width)) return 0;
+		}
+	}
+	return -1;
+}
+
+/** Checks an Adjacency that was loaded: the edges of every vertex are in
+ edges_size, and each one goes to a bit, or a misn if it has E_MISN.
+ @param vertices		The size of start and end.
+ @param bits_size		The bound on to.
+ @param misns_size		The bound on to with E_MISN; zero if there are none.
+ @return	Whether it's safe to use. */
+static int adjacency_is_valid(const struct Adjacency *const a, const int vertices, const int bits_size, const int misns_size) {
+	const struct Edge *e, *end;
+	int v;
+
+	for(v = 0; v < vertices; v++) {
+		if(a->start[v] < 0 || a->start[v] > a->end[v] || a->end[v] > a->edges_size) return 0;
+		for(e = a->edges + a->start[v], end = a->edges + a->end[v]; e < end; e++) {
+			if(e->to < 0 || e->to >= ((e->flags & E_MISN) ? misns_size : bits_size)
+				|| e->where > C_END) return 0;
+		}
+	}
+	return -1;
+}
+
+/** Allocates the arrays of an Adjacency.
+ @return	Success. */
+static int adjacency(struct Adjacency *const a, const int vertices, const int edges) {
+	a->start = malloc(sizeof(int) * (vertices ? 2 * vertices : 1));
+	a->end   = a->start + vertices;
+	a->edges = malloc(sizeof(struct Edge) * (edges ? edges : 1));
+	a->edges_size = edges;
+	if(!a->start || !a->edges) {
+		perror("Graph");
+		adjacency_(a);
+		return 0;
+	}
+	return -1;
+}
+
+static void adjacency_(struct Adjacency *const a) {
+	free(a->start);
+	free(a->edges);
+	a->start = a->end = 0;
+	a->edges = 0;
+}
+
+/** Adds the list of bits (or misns if flags has E_MISN) as edges at e; misns
+ that were never read are left out. Each remembers where it was in the list.
+ @return	The edge after the last one added. */
+static struct Edge *add_edges(struct Edge *e, struct List *const list, const enum Where where, const int flags) {
+	int *pi, *pindex, rank = 0;
+
+	while((pi = ListIterate(list))) {
+		if(!(pindex = MapGet((flags & E_MISN) ? misns.index : bits.index, *pi))) continue;
+		e->to    = *pindex;
+		e->where = (unsigned char)where;
+		e->flags = (unsigned char)flags;
+		e->rank  = (unsigned short)(rank < USHRT_MAX ? rank++ : USHRT_MAX);
+		e++;
 	}
+	return e;
+}
+
+/** Orders by where, bits before misns, set before clear, and then the index;
+ this is the order they are printed.
+ @implements	ListMetric */
+static int edge_compare(const struct Edge *const a, const struct Edge *const b) {
+	if(a->where != b->where) return a->where - b->where;
+	if((a->flags & E_MISN) != (b->flags & E_MISN)) return (a->flags & E_MISN) - (b->flags & E_MISN);
+	if((a->flags & E_SET) != (b->flags & E_SET)) return (b->flags & E_SET) - (a->flags & E_SET);
+	return (a->to > b->to) - (a->to < b->to);
 }
 
-static int misn_compare(const struct Misn *const a, const struct Misn *const b) {
-	struct Cluster *acluster, *bcluster;
-	int i, diff;
+/** @return	The number of edges of v that are where and have exactly flags. */
+static int degree(const struct Adjacency *const a, const int v, const enum Where where, const int flags) {
+	const struct Edge *e, *const end = a->edges + a->end[v];
+	int no = 0;
+
+	for(e = a->edges + a->start[v]; e < end; e++) {
+		if(e->where == where && e->flags == flags) no++;
+	}
+	return no;
+}
 
-	if(!a->is_used) return b->is_used ? -1 : 0; else if(!b->is_used) return 1;
+/** @return	The first edge of v that is where and has exactly flags, or null. */
+static const struct Edge *first(const struct Adjacency *const a, const int v, const enum Where where, const int flags) {
+	const struct Edge *e, *const end = a->edges + a->end[v];
 
-	/* sort all misn bits */
-	for(i = 0; i < misn_helper_size; i++) {
-		acluster = (struct Cluster *)((char *)a + misn_helper[i].bit_cluster);
-		bcluster = (struct Cluster *)((char *)b + misn_helper[i].bit_cluster);
-		ListSort(acluster->set, (ListMetric)&difference);
-		ListSort(acluster->clear, (ListMetric)&difference);
-		ListSort(bcluster->set, (ListMetric)&difference);
-		ListSort(bcluster->clear, (ListMetric)&difference);
-		if((diff = ListCompare(acluster->set, bcluster->set, (ListMetric)&difference)) || (diff = ListCompare(acluster->clear, bcluster->clear, (ListMetric)&difference))) return diff;
+	for(e = a->edges + a->start[v]; e < end; e++) {
+		if(e->where == where && e->flags == flags) return e;
 	}
 	return 0;
 }
 
-/** Entry point.
- @return		Either EXIT_SUCCESS or EXIT_FAILURE. */
-int main(int argc, char **argv) {
-	struct Cron c, *pc;
-	struct Misn m, *pm;
-	char read[2048], *r;
-	const int read_size = sizeof read / sizeof(char);
-	int i;
+/** Adds the bits of the cluster of resource r that is where and has exactly
+ flags to s. */
+static void cluster_bits(struct BitSet *const s, const int r, const enum Where where, const int flags) {
+	const struct Edge *e, *const end = graph.forward.edges + graph.forward.end[r];
 
-	/* display help? */
-	if(argc > 1) { usage(); return EXIT_SUCCESS; }
+	for(e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+		if(e->where == where && e->flags == flags) BitSetAdd(s, e->to);
+	}
+}
 
-	/* read all */
+/** Hashes the bit edges of misn m, which are sorted, and the lists that were
+ emptied; misns that are equal under @see{misn_compare} hash the same.
+ FNV-1a. */
+static unsigned misn_hash(const int m) {
+	const struct Edge *e, *const end = graph.forward.edges + graph.forward.end[m];
+	unsigned hash = 2166136261u;
+
+	if(emptied) hash = (hash ^ emptied[m]) * 16777619u;
+	for(e = graph.forward.edges + graph.forward.start[m]; e < end; e++) {
+		if((e->flags & E_MISN)) continue;
+		hash = (hash ^ (unsigned)e->where) * 16777619u;
+		hash = (hash ^ (unsigned)e->flags) * 16777619u;
+		hash = (hash ^ (unsigned)e->to) * 16777619u;
+	}
+	return hash;
+}
 
-	while(fgets(read, read_size, stdin)) {
+/** Compares the bit edges of misns m and n; a list that the cull emptied is
+ not the same as one that was never there, as it was with the lists. */
+static int misn_compare(const int m, const int n) {
+	const struct Edge *a = graph.forward.edges + graph.forward.start[m],
+		*b = graph.forward.edges + graph.forward.start[n];
+	const struct Edge *const a_end = graph.forward.edges + graph.forward.end[m],
+		*const b_end = graph.forward.edges + graph.forward.end[n];
+	int diff;
+
+	stats.misn_compares++;
+	if(!graph.misns[m].is_used) return graph.misns[n].is_used ? -1 : 0;
+	else if(!graph.misns[n].is_used) return 1;
+	if(emptied && emptied[m] != emptied[n]) return emptied[m] < emptied[n] ? -1 : 1;
+
+	for( ; ; a++, b++) {
+		while(a < a_end && (a->flags & E_MISN)) a++;
+		while(b < b_end && (b->flags & E_MISN)) b++;
+		if(a >= a_end || b >= b_end) return (a < a_end) - (b < b_end);
+		if((diff = edge_compare(a, b))) return diff;
+	}
+}
 
-		if(!strpbrk(read, "\n\r") || !(r = insert_scanf_useless_space(read))) {
-			fprintf(stderr, "Line too long.\n");
+/** Compares the bit edges of misns m and n a cluster at a time, in the order
+ of misn_helper, like the old misn_compare did.
+ @param pequal	If not null, gets how many clusters were equal before the
+				first that was not.
+ @return		The order. */
+static int misn_cluster_compare(const int m, const int n, int *const pequal) {
+	const struct Edge *a = graph.forward.edges + graph.forward.start[m],
+		*b = graph.forward.edges + graph.forward.start[n];
+	const struct Edge *const a_end = graph.forward.edges + graph.forward.end[m],
+		*const b_end = graph.forward.edges + graph.forward.end[n];
+	const unsigned a_emptied = emptied ? emptied[m] : 0,
+		b_emptied = emptied ? emptied[n] : 0;
+	int c, diff = 0;
+
+	for(c = 0; c < misn_helper_size; c++) {
+		if(((a_emptied >> 2 * c) & 3) != ((b_emptied >> 2 * c) & 3)) {
+			diff = ((a_emptied >> 2 * c) & 3) < ((b_emptied >> 2 * c) & 3) ? -1 : 1;
 			break;
 		}
-
-		/* zero temp */
-		memset(&c, 0, sizeof c);
-		c.is_used = -1;
-		memset(&m, 0, sizeof m);
-		m.is_used = -1;
-
-		if(sscanf(r, "\"cron\" %d \"%127[^\"]\" %d %d %d %d %d %d %d %d %d %d \"%127[^\"]\" \"%127[^\"]\" \"%127[^\"]\" %x %x %d %d %d %d %d %d %d %d %d %d \"EOR\"\n",
-			&c.id, c.name, &c.first_day, &c.first_month, &c.first_year,
-			&c.last_day, &c.last_month, &c.last_year, &c.random, &c.duration,
-			&c.pre_holdoff, &c.post_holdoff, c.enable_on, c.on_start, c.on_end,
-			&c.contribute, &c.require, &c.government_1, &c.government_news_1,
-			&c.government_2, &c.government_news_2, &c.government_3,
-			&c.government_news_3, &c.government_4, &c.government_news_4,
-			&c.independent_news, &c.flags) == 27) {
-			if(c.id < 128 || c.id >= crons_size) {
-				fprintf(stderr, "cron %d<%s> is not in range %d.\n", c.id, c.name, crons_size);
-				continue;
-			}
-			escape(c.name);
-
-			pc = crons + c.id;
-			memcpy(pc, &c, sizeof c);
-			parse_resource(pc, cron_helper, cron_helper_size);
-
-		} else if(sscanf(r, "\"misn\" %d \"%127[^\"]\" %d %d %d %d %d %d %d %d %d %d %d %x %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d \"%127[^\"]\" \"%127[^\"]\" \"%127[^\"]\" \"%127[^\"]\" \"%127[^\"]\" \"%127[^\"]\" \"%127[^\"]\" %x %d \"%127[^\"]\" \"%127[^\"]\" %d %d %x %x \"EOR\"\n",
-			&m.id, m.name, &m.available_stellar, &m.available_location,
-			&m.available_record, &m.available_rating, &m.available_random,
-			&m.travel_stellar, &m.return_stellar, &m.cargo_type,
-			&m.cargo_amount, &m.cargo_pickup_mode, &m.cargo_dropoff_mode,
-			&m.scan_mask, &m.pay_value, &m.ship_count, &m.ship_system,
-			&m.ship_dude, &m.ship_goal, &m.ship_behavior, &m.ship_name,
-			&m.ship_start, &m.completion_government, &m.completion_reward,
-			&m.ship_subtitle, &m.briefing_desc, &m.quick_briefing_desc,
-			&m.load_cargo_desc, &m.dropoff_cargo_desc, &m.completion_desc,
-			&m.failing_desc, &m.ship_done_desc, &m.refusing_desc, &m.time_limit,
-			&m.aux_ship_count, &m.aux_ship_dude, &m.aux_ship_syst,
-			&m.available_ship_type, m.available_bits, m.on_accept, m.on_refuse,
-			m.on_success, m.on_failure, m.on_abort, m.on_ship_done,
-			&m.require_bits, &m.date_increment, m.accept_button,
-			m.refuse_button, &m.display_weight, &m.can_abort, &m.flags_1,
-			&m.flags_2) == 53) {
-			if(m.id < 128 || m.id >= misns_size) {
-				fprintf(stderr, "Misn %d<%s> is not in range %d.\n", m.id, m.name, misns_size);
-				continue;
+		for( ; ; a++, b++) {
+			while(a < a_end && (a->flags & E_MISN)) a++;
+			while(b < b_end && (b->flags & E_MISN)) b++;
+			if(a >= a_end || a->where != misn_helper[c].where) {
+				if(b < b_end && b->where == misn_helper[c].where) diff = -1;
+				break;
 			}
-			escape(m.name);
+			if(b >= b_end || b->where != misn_helper[c].where) { diff = 1; break; }
+			if((diff = edge_compare(a, b))) break;
+		}
+		if(diff) break;
+	}
+	if(pequal) *pequal = c;
+	return diff;
+}
 
-			pm = misns + m.id;
-			memcpy(pm, &m, sizeof m);
-			parse_resource(pm, misn_helper, misn_helper_size);
+/** @return	The bit lists of misn m that have edges, a bit for each, two for
+			each cluster in the order of misn_helper, set first. */
+static unsigned misn_lists(const int m) {
+	const struct Edge *e, *const end = graph.forward.edges + graph.forward.end[m];
+	unsigned lists = 0;
 
+	for(e = graph.forward.edges + graph.forward.start[m]; e < end; e++) {
+		if(!(e->flags & E_MISN)) lists |= 1u << (2 * e->where + !(e->flags & E_SET));
+	}
+	return lists;
+}
+
+/** @implements	ListMetric */
+static int misn_order(const int *const a, const int *const b) {
+	return misn_cluster_compare(*a, *b, 0);
+}
+
+/** Entry point.
+ @return		Either EXIT_SUCCESS or EXIT_FAILURE. */
+int main(int argc, char **argv) {
+	struct Cron *pc;
+	struct Misn *pm;
+	int threads = 1, i, is_error = 0;
+
+	/* arguments; the rest are the inputs */
+	for(i = 1; i < argc && argv[i][0] == '-' && argv[i][1]; i++) {
+		if(!strcmp(argv[i], "-j") && i + 1 < argc
+			&& read_int(&threads, argv[i + 1]) && threads > 0) {
+			i++;
+		} else if(!strcmp(argv[i], "-c") && i + 1 < argc) {
+			cache_path = argv[++i];
+		} else if(!strcmp(argv[i], "--save-graph") && i + 1 < argc) {
+			save_path = argv[++i];
+		} else if(!strcmp(argv[i], "--load-graph") && i + 1 < argc) {
+			load_path = argv[++i];
+		} else if(!strcmp(argv[i], "--stream")) {
+			is_stream = -1;
+		} else if(!strcmp(argv[i], "--reach")) {
+			is_reach = -1;
+		} else if(!strcmp(argv[i], "--explore")) {
+			is_explore = -1;
+		} else if(!strcmp(argv[i], "--explore-depth") && i + 1 < argc
+			&& read_int(&explore_depth, argv[i + 1]) && explore_depth >= 0) {
+			i++;
+		} else if(!strcmp(argv[i], "--explore-states") && i + 1 < argc
+			&& read_int(&explore_states, argv[i + 1]) && explore_states > 0) {
+			i++;
+		} else if(!strcmp(argv[i], "--focus") && i + 1 < argc) {
+			focus_spec = argv[++i];
+		} else if(!strcmp(argv[i], "--depth") && i + 1 < argc
+			&& read_int(&focus_depth, argv[i + 1]) && focus_depth >= 0) {
+			i++;
+		} else if(!strcmp(argv[i], "--direction") && i + 1 < argc
+			&& (!strcmp(argv[i + 1], "forward") || !strcmp(argv[i + 1], "backward")
+			|| !strcmp(argv[i + 1], "both"))) {
+			i++;
+			is_focus_forward  = strcmp(argv[i], "backward");
+			is_focus_backward = strcmp(argv[i], "forward");
+		} else if(!strcmp(argv[i], "--simulate") && i + 1 < argc
+			&& read_int(&simulate_years, argv[i + 1]) && simulate_years > 0) {
+			i++;
+		} else if(!strcmp(argv[i], "--start") && i + 1 < argc
+			&& read_date(&simulate_start, argv[i + 1])) {
+			i++;
+		} else if(!strcmp(argv[i], "--seed") && i + 1 < argc
+			&& read_int(&simulate_seed, argv[i + 1]) && simulate_seed > 0) {
+			i++;
+		} else if(!strcmp(argv[i], "--timing")) {
+			is_timing = -1;
+		} else if(!strcmp(argv[i], "--stats") && i + 1 < argc) {
+			stats_path = argv[++i];
+			ListCounting();
+		} else {
+			usage();
+			return EXIT_SUCCESS;
 		}
-	};
+	}
+	/* --stream has one record at a time; the rest need all of them */
+	if(is_stream && (threads > 1 || cache_path || save_path || load_path
+		|| is_reach || is_explore || simulate_years || focus_spec
+		|| stats_path || is_timing)) {
+		fprintf(stderr, "--stream can't be used with -j, -c, --save-graph, --load-graph, --reach,\n--explore, --simulate, --focus, --stats, or --timing.\n\n");
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	if(!store(&bits, "Bit", sizeof(struct Bit), offsetof(struct Bit, bit), (ListMetric)&bit_compare_id)
+		|| !store(&misns, "Misn", sizeof(struct Misn), offsetof(struct Misn, id), (ListMetric)&misn_compare_id)
+		|| !store(&crons, "Cron", sizeof(struct Cron), offsetof(struct Cron, id), (ListMetric)&cron_compare_id)
+		|| !(clusters = ListArena())) {
+		store_(&bits);
+		store_(&misns);
+		store_(&crons);
+		return EXIT_FAILURE;
+	}
+
+	/* print as it's read, without the culls */
+	if(is_stream) {
+		is_error = !stream(argv + i, argc - i);
+		store_(&bits);
+		store_(&misns);
+		store_(&crons);
+		ListArena_(&clusters);
+		return is_error ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	/* read all, or the graph from before */
+
+	stage_start(P_READ);
+	if(load_path) {
+		if(argc > i) fprintf(stderr, "Warning: %s is loaded; the input files are ignored.\n", load_path);
+		is_error = !graph_load();
+		stats.misns_read = graph.misns_size;
+		stats.crons_read = graph.crons_size;
+	} else {
+		is_error = !input(argv + i, argc - i, threads);
+		stage_start(P_FREEZE);
+		/* unless it came from the cache */
+		if(!is_error && !graph.snapshot) is_error = !freeze();
+		if(!is_error && cache_path && !cache_save()) is_error = -1;
+		cache_();
+	}
+	ListArena_(&clusters);
+	if(!is_error && save_path && !graph_save()) is_error = -1;
+	if(is_error) {
+		graph_();
+		store_(&bits);
+		store_(&misns);
+		store_(&crons);
+		ListArena_(&clusters);
+		return EXIT_FAILURE;
+	}
+
+	/* instead of the GraphViz, on the whole graph */
+	if(is_reach || is_explore || simulate_years) {
+		stage_start(P_ANALYSE);
+		if(is_reach && !reach()) is_error = -1;
+		if(!is_error && is_explore && !explore(threads)) is_error = -1;
+		if(!is_error && simulate_years && !simulate()) is_error = -1;
+		stage_start(P_SIZE);
+		if(is_timing) timing_print();
+		if(stats_path && !stats_print()) is_error = -1;
+		graph_();
+		store_(&bits);
+		store_(&misns);
+		store_(&crons);
+		return is_error ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
 
 	/* get rid of stuff */
 
+	stage_start(P_CULL_CRONS);
 	cull_bits_reset_by_crons();
 
 	/* fixme: eg, 379: Report Mu'hari; Vellos24a: if it sets a bit and then clears it
@@ -431,199 +1253,2451 @@ int main(int argc, char **argv) {
 
 	/* combine misns that only differ by one availible-not bit */
 
+	stage_start(P_CULL_DEGREE);
 	cull_misns_out_degree_zero();
 
+	stage_start(P_MERGE);
 	merge_misns();
 
-	/* print all */
+	/* only the neighbourhood */
+	if(focus_spec) {
+		stage_start(P_ANALYSE);
+		if(!focus_find()) {
+			graph_();
+			store_(&bits);
+			store_(&misns);
+			store_(&crons);
+			return EXIT_FAILURE;
+		}
+	}
 
-	printf("digraph misn {\nrankdir = \"LR\";\n\n");
+	/* print all */
 
-	/* print misns and vertices */
-	printf("node [shape=Mrecord style=filled fillcolor=\"#1111EE5f\"];\n");
-	for(i = 0; i < misns_size; i++) {
-		pm = misns + i;
-		if(!pm->is_used) continue;
-		printf("misn%d [label=\"{%d: %s|{<accept>accept|<refuse>refuse}|<ship>ship|{<success>success|<failure>failure|<abort>abort}}\"];\n", pm->id, pm->id, pm->name);
+	stage_start(P_EMIT);
+	/* out is the buffer; nothing has been written to stdout yet */
+	setvbuf(stdout, 0, _IONBF, 0);
+	if(!(out = Out(stdout, out_buffer, sizeof out_buffer))) {
+		fprintf(stderr, "Out: %s.\n", OutError(0));
+		graph_();
+		store_(&bits);
+		store_(&misns);
+		store_(&crons);
+		return EXIT_FAILURE;
+	}
 
-		print_edges(i, &pm->b_available, 0, "misn", 0);
-		print_edges(i, &pm->b_accept, &pm->misn_accept, "misn", "accept");
-		print_edges(i, &pm->b_refuse, &pm->misn_refuse, "misn", "refuse");
-		print_edges(i, &pm->b_success, &pm->misn_success, "misn", "success");
-		print_edges(i, &pm->b_failure, &pm->misn_failure, "misn", "failure");
-		print_edges(i, &pm->b_abort, &pm->misn_abort, "misn", "abort");
-		print_edges(i, &pm->b_ship, &pm->misn_ship, "misn", "ship");
+	OutString(out, "digraph misn {\nrankdir = \"LR\";\n\n");
 
+	/* print misns and vertices */
+	OutString(out, "node [shape=Mrecord style=filled fillcolor=\"#1111EE5f\"];\n");
+	for(i = 0; i < graph.misns_size; i++) {
+		pm = graph.misns + i;
+		if(!pm->is_used || (focus && !BitSetHas(focus, i))) continue;
+		stats.nodes_emitted++;
+		OutString(out, "misn");
+		OutInt(out, pm->id);
+		OutString(out, " [label=\"{");
+		OutInt(out, pm->id);
+		OutString(out, ": ");
+		OutString(out, pm->name);
+		OutString(out, "|{<accept>accept|<refuse>refuse}|<ship>ship|{<success>success|<failure>failure|<abort>abort}}\"];\n");
+		print_edges(i, "misn", pm->id);
 	}
-	printf("\n");
+	OutChar(out, '\n');
 
 	/* print crons and vertices */
-	printf("node [shape=record style=filled fillcolor=\"#EE11115f\"];\n");
-	for(i = 0; i < crons_size; i++) {
-		pc = crons + i;
-		if(!pc->is_used) continue;
-		printf("cron%d [label=\"{%d: %s|{<start>start|<end>end}}\"];\n", pc->id, pc->id, pc->name);
-
-		print_edges(i, &pc->b_enable, 0, "cron", 0);
-		print_edges(i, &pc->b_start, 0, "cron", "start");
-		print_edges(i, &pc->b_end, 0, "cron", "end");
-
+	OutString(out, "node [shape=record style=filled fillcolor=\"#EE11115f\"];\n");
+	for(i = 0; i < graph.crons_size; i++) {
+		pc = graph.crons + i;
+		if(!pc->is_used || (focus && !BitSetHas(focus, graph.misns_size + i))) continue;
+		stats.nodes_emitted++;
+		OutString(out, "cron");
+		OutInt(out, pc->id);
+		OutString(out, " [label=\"{");
+		OutInt(out, pc->id);
+		OutString(out, ": ");
+		OutString(out, pc->name);
+		OutString(out, "|{<start>start|<end>end}}\"];\n");
+		print_edges(graph.misns_size + i, "cron", pc->id);
 	}
-	printf("\n");
+	OutChar(out, '\n');
 
 	/* print bits for all used bits */
-	printf("node [constraint=false shape=plain style=dotted fillcolor=\"#11EE115f\"];\n");
-	for(i = 0; i < bits_size; i++) {
-		if(!bits[i].is_used) continue;
-		printf("bit%d [label=\"%d\" constraint=false shape=plain style=dotted fillcolor=\"#11EE115f\"];\n", i, i);
+	OutString(out, "node [constraint=false shape=plain style=dotted fillcolor=\"#11EE115f\"];\n");
+	for(i = 0; i < graph.bits_size; i++) {
+		if(!graph.bits[i].is_used || (focus && !BitSetHas(focus, graph.misns_size + graph.crons_size + i))) continue;
+		stats.nodes_emitted++;
+		OutString(out, "bit");
+		OutInt(out, graph.bits[i].bit);
+		OutString(out, " [label=\"");
+		OutInt(out, graph.bits[i].bit);
+		OutString(out, "\" constraint=false shape=plain style=dotted fillcolor=\"#11EE115f\"];\n");
 	}
-	printf("\n");
-
-	printf("}\n");
+	OutChar(out, '\n');
 
-	/* fixme: free */
+	OutString(out, "}\n");
 
-	return EXIT_SUCCESS;
-}
+	if(!Out_(&out)) {
+		fprintf(stderr, "Out: %s.\n", OutError(0));
+		is_error = -1;
+	}
+	stage_start(P_SIZE);
+	if(is_timing) timing_print();
+	if(stats_path && !stats_print()) is_error = -1;
 
-/** only the most obvious! (most famous b6666) */
-static void cull_bits_reset_by_crons(void) {
-	struct List *ignore_bits = List(sizeof(int));
-	struct Misn *misn;
-	int i, *pbit;
+	BitSet_(&focus);
+	graph_();
+	store_(&bits);
+	store_(&misns);
+	store_(&crons);
 
-	/* first we must get the bits reset by crons */
-	for(i = 0; i < crons_size; i++) {
-		struct Cron *const cron = crons + i;
-		int is_start;
-		int *pstart, *pend, b;
+	return is_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
 
-		if(!cron->is_used) continue;
-		if(ListSize(cron->b_enable.set) != 1) continue;
-		if(ListSize(cron->b_enable.clear) != 0) continue;
-		if(ListSize(cron->b_start.clear) + ListSize(cron->b_end.clear) != 1) continue;
-		if(ListSize(cron->b_start.set) != 0 || ListSize(cron->b_end.set) != 0) continue;
-		is_start = (ListSize(cron->b_start.clear) == 1);
-		pstart = ListGet(cron->b_enable.set, 0);
-		pend = ListGet((ListSize(cron->b_start.clear) == 1) ? cron->b_start.clear : cron->b_end.clear, 0);
-		/* match */
-		if((b = *pstart) != *pend) continue;
-		/* misn's available set bits, than it can safely be ignored */
-		if(!ListSize(bits[b].misn_available.set)) ListAdd(ignore_bits, &b);
-		cron->is_used = 0; /* we don't care about the cron */
+/** Finds which misns and crons a new pilot, with all the bits clear, could
+ ever get to, and prints the ones that it can't on stdout. A bit can be set if
+ something that can be reached sets it; a misn can be reached if its available
+ test could be true with the bits that can be set, or if a misn that can be
+ reached starts it; a cron, if its enable test could. Any bit could be clear,
+ since all bits start clear, so this is an upper bound: what it says is
+ unreachable really is. Every bit and resource goes on the work list once,
+ when it's first reached, and a bit only runs the tests that it's in again.
+ @return	Success. */
+static int reach(void) {
+	const int vertices = graph.misns_size + graph.crons_size;
+	struct BitSet *can_set = BitSet(graph.bits_size), *reached = BitSet(vertices);
+	struct Tests t = { 0, 0, 0 };
+	int *work = 0, work_size = 0, bits_set, misns_reached, crons_reached, r, v, *w, *w_end;
+	const struct Edge *e, *end;
+
+	if(!can_set || !reached
+		|| !(work = malloc(sizeof *work * (vertices + graph.bits_size + 1)))) {
+		fprintf(stderr, "Reach: %s.\n", can_set && reached ? strerror(errno) : BitSetError(0));
+		free(work);
+		BitSet_(&reached);
+		BitSet_(&can_set);
+		return 0;
+	}
+	if(!tests(&t)) {
+		free(work);
+		BitSet_(&reached);
+		BitSet_(&can_set);
+		return 0;
+	}
+	/* the work list has resources [0, vertices) and then bits */
+	for(r = 0; r < vertices; r++) {
+		if(t.exprs[r] && !ExprCould(t.exprs[r], can_set, 0)) continue;
+		BitSetAdd(reached, r);
+		work[work_size++] = r;
+	}
+	while(work_size) {
+		v = work[--work_size];
+		if(v < vertices) {
+			/* what it sets, and the misns it starts */
+			end = graph.forward.edges + graph.forward.end[v];
+			for(e = graph.forward.edges + graph.forward.start[v]; e < end; e++) {
+				if(!(e->flags & E_SET) || e->where == M_AVAILABLE || e->where == C_ENABLE) continue;
+				if((e->flags & E_MISN)) {
+					if(BitSetHas(reached, e->to)) continue;
+					BitSetAdd(reached, e->to);
+					work[work_size++] = e->to;
+				} else {
+					if(BitSetHas(can_set, e->to)) continue;
+					BitSetAdd(can_set, e->to);
+					work[work_size++] = vertices + e->to;
+				}
+			}
+		} else {
+			/* the tests that it's in could be true now */
+			v -= vertices;
+			w_end = t.watch + t.watch_start[v + 1];
+			for(w = t.watch + t.watch_start[v]; w < w_end; w++) {
+				if(BitSetHas(reached, *w) || !ExprCould(t.exprs[*w], can_set, 0)) continue;
+				BitSetAdd(reached, *w);
+				work[work_size++] = *w;
+			}
+		}
 	}
-	fprintf(stderr, "Cron ignore bits: ");
-	ListSort(ignore_bits, (ListMetric)&difference); /* just because */
-	print_ints(ignore_bits);
-	fprintf(stderr, "\n");
 
-	/* delete all misn bits that are in ignore_bits */
-	for(i = 0; i < misns_size; i++) {
-		misn = misns + i;
-		if(!misn->is_used) continue;
-		while((pbit = ListIterate(ignore_bits))) delete_bit_from_misn(misn, *pbit);
+	bits_set = BitSetCount(can_set);
+	for(misns_reached = 0, r = 0; r < graph.misns_size; r++) if(BitSetHas(reached, r)) misns_reached++;
+	crons_reached = BitSetCount(reached) - misns_reached;
+	printf("From all bits clear, %d of %d misns and %d of %d crons can be reached, and %d of %d bits can be set.\n",
+		misns_reached, graph.misns_size, crons_reached, graph.crons_size, bits_set, graph.bits_size);
+	printf("\nUnreachable misns:\n");
+	for(r = 0; r < graph.misns_size; r++) {
+		if(BitSetHas(reached, r)) continue;
+		printf("misn%d\t%s\t", graph.misns[r].id, graph.misns[r].name);
+		/* the bits that it's waiting on */
+		end = graph.forward.edges + graph.forward.end[r];
+		for(e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+			if(e->where == M_AVAILABLE && e->flags == E_SET && !BitSetHas(can_set, e->to)) printf(" b%d", graph.bits[e->to].bit);
+		}
+		printf("\n");
+	}
+	printf("\nUnreachable crons:\n");
+	for(r = graph.misns_size; r < vertices; r++) {
+		if(BitSetHas(reached, r)) continue;
+		printf("cron%d\t%s\t", graph.crons[r - graph.misns_size].id, graph.crons[r - graph.misns_size].name);
+		end = graph.forward.edges + graph.forward.end[r];
+		for(e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+			if(e->where == C_ENABLE && e->flags == E_SET && !BitSetHas(can_set, e->to)) printf(" b%d", graph.bits[e->to].bit);
+		}
+		printf("\n");
 	}
-	/* also delete the bits from bits */
-	while((pbit = ListIterate(ignore_bits))) bits[*pbit].is_used = 0;
 
-	List_(&ignore_bits);
+	tests_(&t);
+	free(work);
+	BitSet_(&reached);
+	BitSet_(&can_set);
+	if(ferror(stdout)) {
+		fprintf(stderr, "Reach: %s.\n", strerror(errno));
+		return 0;
+	}
+	return -1;
 }
 
-/** nodes who's out degrees are zero are useless */
-static void cull_misns_out_degree_zero(void) {
-	int i;
-
-	for(i = M_ACCEPT; i < misns_size; i++) {
-		struct Misn *const misn = misns + i;
-		int no = 0, field;
-		if(!misn->is_used) continue;
-		for(field = 0; field < misn_helper_size; field++) {
-			struct Cluster *cluster = (struct Cluster *)((char *)misn + misn_helper[field].bit_cluster);
-			no += ListSize(cluster->set);
-			no += ListSize(cluster->clear);
+/** Compiles the available tests of the misns and the enable tests of the
+ crons into t, with the bits as indices into graph.bits; a bit that's not in
+ the graph is never set. A test that can't be compiled is warned about and is
+ taken to be true.
+ @return	Success. */
+static int tests(struct Tests *const t) {
+	const int vertices = graph.misns_size + graph.crons_size;
+	struct List *watches = 0;
+	struct Watch *w;
+	const char *text;
+	int r, b;
+
+	t->exprs = 0;
+	t->watch_start = 0;
+	t->watch = 0;
+	if(!(t->exprs = calloc(vertices ? vertices : 1, sizeof *t->exprs))
+		|| !(t->watch_start = calloc(graph.bits_size + 1, sizeof *t->watch_start))
+		|| !(watches = List(sizeof(struct Watch)))) {
+		fprintf(stderr, "Tests: %s.\n", watches || !t->watch_start ? strerror(errno) : ListError(0));
+		tests_(t);
+		return 0;
+	}
+	ListSetParam(watches, &r);
+	for(r = 0; r < vertices; r++) {
+		text = r < graph.misns_size ? graph.misns[r].available_bits
+			: graph.crons[r - graph.misns_size].enable_on;
+		if(!(t->exprs[r] = Expr(text))) {
+			fprintf(stderr, "Warning: <%s> %s; taking it to be true.\n", text, ExprError(0));
+			continue;
 		}
-		if(no) continue;
-		misn->is_used = 0;
-		fprintf(stderr, "Misn%d has zero out-degree; it has been repressed.\n", misn->id);
+		ExprMap(t->exprs[r], &tests_map, watches);
+	}
+	if((text = ListError(watches))) {
+		fprintf(stderr, "Tests: %s.\n", text);
+		List_(&watches);
+		tests_(t);
+		return 0;
 	}
+	/* the bits index the resources that test them */
+	if(!(t->watch = malloc(sizeof *t->watch * (ListSize(watches) + 1)))) {
+		fprintf(stderr, "Tests: %s.\n", strerror(errno));
+		List_(&watches);
+		tests_(t);
+		return 0;
+	}
+	while((w = ListIterate(watches))) t->watch_start[w->bit + 1]++;
+	for(b = 0; b < graph.bits_size; b++) t->watch_start[b + 1] += t->watch_start[b];
+	while((w = ListIterate(watches))) t->watch[t->watch_start[w->bit]++] = w->resource;
+	for(b = graph.bits_size; b > 0; b--) t->watch_start[b] = t->watch_start[b - 1];
+	t->watch_start[0] = 0;
+	List_(&watches);
+	return -1;
 }
 
-/** merges the misns that have the same topology */
-static void merge_misns(void) {
-	struct Misn *misn, *nisn;
-	int m, n;
-	char temp[128];
+/** Frees what @see{tests} made. */
+static void tests_(struct Tests *const t) {
+	int r;
 
-	for(m = 0; m < misns_size; m++) {
-		misn = misns + m;
-		if(!misn->is_used) continue;
-		for(n = m + 1; n < misns_size; n++) {
-			nisn = misns + n;
-			if(!nisn->is_used || misn_compare(misn, nisn)) continue;
-			snprintf(temp, sizeof temp, "\\n%d: %s", nisn->id, nisn->name);
-			strncat(misn->name, temp, misn_name_size);
-			nisn->is_used = 0;
-			fprintf(stderr, "Misn%d merged with Misn%d.\n", nisn->id, misn->id);
-		}
+	if(t->exprs) {
+		for(r = 0; r < graph.misns_size + graph.crons_size; r++) Expr_(&t->exprs[r]);
 	}
+	free(t->exprs);
+	free(t->watch_start);
+	free(t->watch);
+	t->exprs = 0;
+	t->watch_start = 0;
+	t->watch = 0;
 }
 
-/** if the sub_label is 0, then assumes edge is incedent */
-static void print_edges(const int vertex, const struct Cluster *const bit, const struct Cluster *const misn, const char *const label, const char *const sub_label) {
-	int *pb, *pm;
+/** Finds the bit in the graph and remembers that the resource that's being
+ compiled tests it.
+ @param param	The list of struct Watch, with the resource as the list's
+				param.
+ @implements	ExprMapping */
+static int tests_map(const int bit, void *const param) {
+	struct List *const watches = param;
+	struct Watch w;
+
+	if((w.bit = graph_find((const char *)graph.bits, &bits, graph.bits_size, bit)) == -1) return -1;
+	w.resource = *(int *)ListGetParam(watches);
+	ListAdd(watches, &w);
+	return w.bit;
+}
 
-	if(sub_label) {
-		/* set expression */
-		while((pb = ListIterate(bit->set))) {
-			printf("%s%d:%s -> bit%d;\n", label, vertex, sub_label, *pb);
+/** Explores the states that the bits can get into from all clear, on threads
+ threads: from a state, a misn whose available test is true can be done, which
+ applies its accept and success effects, and a cron whose enable test is true
+ can start, or start and end. Only the bits that some test reads are part of
+ the state. It goes to explore_depth transitions, or until there are
+ explore_states states. Then it prints, on stdout, the misns that are started or
+ aborted by another, but were never available in any state that was seen.
+ @return	Success. */
+static int explore(const int threads) {
+	struct Explorer x;
+	struct Explore *t;
+	struct ExploreItem start;
+	const struct Edge *e, *end;
+	unsigned long seed = 1;
+	char *item = 0;
+	int i, b, r, k, degree_max = 1, states = 0, no = 0, is_ok = -1;
+
+	x.zobrist    = 0;
+	x.starts     = 0;
+	x.threads    = threads;
+	x.taken      = 0;
+	x.is_full    = 0;
+	x.errno_copy = 0;
+	x.shards     = 0;
+	x.explores   = 0;
+	if(!tests(&x.tests)) return 0;
+	if((errno = pthread_mutex_init(&x.lock, 0))) {
+		fprintf(stderr, "Explore: %s.\n", strerror(errno));
+		tests_(&x.tests);
+		return 0;
+	}
+	if(!(x.zobrist = malloc(sizeof *x.zobrist * (graph.bits_size ? graph.bits_size : 1)))
+		|| !(x.starts = malloc(sizeof *x.starts * (graph.misns_size + graph.crons_size + 1)))
+		|| !(x.shards = calloc(shards_size, sizeof *x.shards))
+		|| !(x.explores = calloc(threads, sizeof *x.explores))) {
+		fprintf(stderr, "Explore: %s.\n", strerror(errno));
+		explore_(&x, 0);
+		return 0;
+	}
+	for(b = 0; b < graph.bits_size; b++) {
+		x.zobrist[b].a = random_next(&seed);
+		x.zobrist[b].b = random_next(&seed);
+	}
+	for(i = 0; i < shards_size; i++) {
+		x.shards[i].zero_depth = -1;
+		x.shards[i].capacity = 16;
+		if(!(x.shards[i].visits = calloc(x.shards[i].capacity, sizeof *x.shards[i].visits))
+			|| pthread_mutex_init(&x.shards[i].lock, 0)) {
+			fprintf(stderr, "Explore: %s.\n", strerror(errno));
+			free(x.shards[i].visits);
+			x.shards[i].visits = 0;
+			explore_(&x, 0);
+			return 0;
+		}
+	}
+	/* the starts and aborts are numbered in the order of the edges */
+	for(x.starts[0] = 0, r = 0; r < graph.misns_size + graph.crons_size; r++) {
+		if(graph.forward.end[r] - graph.forward.start[r] > degree_max) degree_max = graph.forward.end[r] - graph.forward.start[r];
+		x.starts[r + 1] = x.starts[r];
+		end = graph.forward.edges + graph.forward.end[r];
+		for(e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+			if((e->flags & E_MISN)) x.starts[r + 1]++;
+		}
+	}
+	for(i = 0; i < threads; i++) {
+		t = x.explores + i;
+		if(!(t->state = BitSet(graph.bits_size))
+			|| !(t->available = BitSet(graph.misns_size))) {
+			fprintf(stderr, "Explore: %s.\n", BitSetError(0));
+			explore_(&x, threads);
+			return 0;
 		}
-		while((pb = ListIterate(bit->clear))) {
-			printf("%s%d:%s -> bit%d [color=red arrowhead=empty style=dashed];\n", label, vertex, sub_label, *pb);
+		x.width = sizeof(struct ExploreItem) + BitSetBytes(t->state);
+		if(!(t->undo = malloc(sizeof *t->undo * degree_max))
+			|| !(t->started = malloc(sizeof *t->started * degree_max * 2))
+			|| !(t->item = malloc(x.width))
+			|| !(t->broken_depth = malloc(sizeof *t->broken_depth * (x.starts[r] ? x.starts[r] : 1)))
+			|| !(t->broken_count = calloc(x.starts[r] ? x.starts[r] : 1, sizeof *t->broken_count))) {
+			fprintf(stderr, "Explore: %s.\n", strerror(errno));
+			explore_(&x, threads);
+			return 0;
 		}
-		/* print edges that start automatically */
-		if(!misn) return;
-		while((pm = ListIterate(misn->set))) {
-			if(!misns[*pm].is_used) continue;
-			printf("%s%d:%s -> misn%d [color=green];\n", label, vertex, sub_label, *pm);
+		for(k = 0; k < x.starts[r]; k++) t->broken_depth[k] = -1;
+	}
+
+	/* all clear */
+	start.depth = 0;
+	start.key.a = start.key.b = 0;
+	shard_add(&x, x.explores, &start);
+	if(!(item = calloc(1, x.width))) {
+		fprintf(stderr, "Explore: %s.\n", strerror(errno));
+		explore_(&x, threads);
+		return 0;
+	}
+	memcpy(item, &start, sizeof start);
+	if(!WorkSteal(threads, x.width, item, 1, (WorkTask)&explore_task, &x)) {
+		fprintf(stderr, "Explore: %s.\n", WorkError());
+		is_ok = 0;
+	}
+	free(item);
+	if(is_ok && x.errno_copy) {
+		fprintf(stderr, "Explore: %s.\n", strerror(x.errno_copy));
+		is_ok = 0;
+	}
+
+	if(is_ok) {
+		t = x.explores;
+		for(states = t->states, i = 1; i < threads; i++) {
+			BitSetUnion(t->available, x.explores[i].available);
+			states += x.explores[i].states;
+			for(k = 0; k < x.starts[graph.misns_size + graph.crons_size]; k++) {
+				if(x.explores[i].broken_depth[k] != -1 && (t->broken_depth[k] == -1
+					|| x.explores[i].broken_depth[k] < t->broken_depth[k]))
+					t->broken_depth[k] = x.explores[i].broken_depth[k];
+				t->broken_count[k] += x.explores[i].broken_count[k];
+			}
 		}
-		while((pm = ListIterate(misn->clear))) {
-			if(!misns[*pm].is_used) continue;
-			printf("%s%d:%s -> misn%d [color=green arrowhead=empty style=dashed];\n", label, vertex, sub_label, *pm);
+		printf("From all bits clear, %d states were explored to a depth of %d%s; %d of %d misns were available in one.\n",
+			states, explore_depth, x.is_full ? ", as many as --explore-states allows" : "",
+			BitSetCount(t->available), graph.misns_size);
+		printf("\nStarted or aborted where it's not available right after:\n");
+		for(r = 0; r < graph.misns_size + graph.crons_size; r++) {
+			end = graph.forward.edges + graph.forward.end[r];
+			for(k = x.starts[r], e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+				if(!(e->flags & E_MISN)) continue;
+				if(t->broken_depth[k] != -1) {
+					if(r < graph.misns_size) printf("misn%d\t%s", graph.misns[r].id, graph.misns[r].name);
+					else printf("cron%d\t%s", graph.crons[r - graph.misns_size].id, graph.crons[r - graph.misns_size].name);
+					printf("\t%s %s\tmisn%d\t%s\t%d times, first at depth %d\n", where_name[e->where],
+						e->flags & E_SET ? "starts" : "aborts", graph.misns[e->to].id,
+						graph.misns[e->to].name, t->broken_count[k], t->broken_depth[k]);
+					no++;
+				}
+				k++;
+			}
 		}
-	} else {
-		/* test expression -- edge incident to node */
-		while((pb = ListIterate(bit->set))) {
-			printf("bit%d -> %s%d;\n", *pb, label, vertex);
+		if(!no) printf("(none)\n");
+		no = 0;
+		printf("\nStarted or aborted, but never available:\n");
+		for(r = 0; r < graph.misns_size + graph.crons_size; r++) {
+			end = graph.forward.edges + graph.forward.end[r];
+			for(e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+				if(!(e->flags & E_MISN) || BitSetHas(t->available, e->to)) continue;
+				if(r < graph.misns_size) printf("misn%d\t%s", graph.misns[r].id, graph.misns[r].name);
+				else printf("cron%d\t%s", graph.crons[r - graph.misns_size].id, graph.crons[r - graph.misns_size].name);
+				printf("\t%s %s\tmisn%d\t%s\n", where_name[e->where], e->flags & E_SET ? "starts" : "aborts",
+					graph.misns[e->to].id, graph.misns[e->to].name);
+				no++;
+			}
 		}
-		while((pb = ListIterate(bit->clear))) {
-			/*if(list_contains_int(ignore_bits, *pb)) {
-				fprintf(stderr, "Ignoring Misn%d test clear b%d.\n", vertex, *pb);
-				continue;
-			}*/
-			printf("bit%d -> %s%d [color=red arrowhead=empty style=dashed];\n", *pb, label, vertex);
+		if(!no) printf("(none)\n");
+		if(ferror(stdout)) {
+			fprintf(stderr, "Explore: %s.\n", strerror(errno));
+			is_ok = 0;
 		}
 	}
+	explore_(&x, threads);
+	return is_ok;
 }
 
-/** ::facepalm:: scanf can't handle empty strings, for some weird reason; used
- when reading */
-static char *insert_scanf_useless_space(char *const str) {
-	static char read[2048];
-	char *str1, *str2;
-	const int read_size = sizeof read / sizeof(char);
-	int read_pos = 0, remainder;
+/** Frees what @see{explore} made, with threads of x.explores. */
+static void explore_(struct Explorer *const x, const int threads) {
+	struct Explore *t;
+	int i;
 
-	for(str1 = str; (str2 = strstr(str1, "\"\"")); str1 = str2 + 2) {
-		if(read_size - read_pos < str2 - str1 + 4) return 0;
-		memcpy(read + read_pos, str1, str2 - str1);
-		read_pos += str2 - str1;
-		memcpy(read + read_pos, "\" \"", 3);
-		read_pos += 3;
+	for(i = 0; x->explores && i < threads; i++) {
+		t = x->explores + i;
+		BitSet_(&t->state);
+		BitSet_(&t->available);
+		free(t->undo);
+		free(t->started);
+		free(t->item);
+		free(t->broken_depth);
+		free(t->broken_count);
 	}
-	/* untested boundry values */
-	if((remainder = strlen(str1) + 1) > read_size - read_pos) return 0;
-	memcpy(read + read_pos, str1, remainder);
-	return read;
+	for(i = 0; x->shards && i < shards_size && x->shards[i].visits; i++) {
+		pthread_mutex_destroy(&x->shards[i].lock);
+		free(x->shards[i].visits);
+	}
+	free(x->explores);
+	free(x->shards);
+	free(x->zobrist);
+	free(x->starts);
+	pthread_mutex_destroy(&x->lock);
+	tests_(&x->tests);
+	x->explores = 0;
+	x->shards = 0;
+	x->zobrist = 0;
+	x->starts = 0;
+}
+
+/** Does the transitions out of one state; the ones that go to new states are
+ pushed.
+ @implements	WorkTask */
+static void explore_task(struct Explorer *const x, const int worker, void *const item, struct WorkQueue *const q) {
+	struct Explore *const t = x->explores + worker;
+	struct ExploreItem from;
+	struct Expr *test;
+	int r;
+
+	memcpy(&from, item, sizeof from);
+	BitSetLoad(t->state, (char *)item + sizeof from);
+	for(r = 0; r < graph.misns_size + graph.crons_size; r++) {
+		if((test = x->tests.exprs[r]) && !ExprEvaluate(test, t->state)) continue;
+		if(r < graph.misns_size) {
+			BitSetAdd(t->available, r);
+			if(from.depth >= explore_depth) continue;
+			explore_next(x, t, q, &from, r, M_ACCEPT, M_SUCCESS);
+		} else {
+			if(from.depth >= explore_depth) break;
+			explore_next(x, t, q, &from, r, C_START, C_START);
+			explore_next(x, t, q, &from, r, C_START, C_END);
+		}
+	}
+}
+
+/** Applies the effects of resource r that are where0 or where1 to the state,
+ notes the misns it starts or aborts that aren't available in the result,
+ pushes it if it's new, and changes the state back; it's cheaper than a copy,
+ since most transitions go to states that have been seen. */
+static void explore_next(struct Explorer *const x, struct Explore *const t, struct WorkQueue *const q, const struct ExploreItem *const from, const int r, const enum Where where0, const enum Where where1) {
+	const struct Edge *e, *const end = graph.forward.edges + graph.forward.end[r];
+	struct ExploreItem to;
+	int undo_size = 0, started_size = 0, i = x->starts[r], m;
+
+	to.depth = from->depth + 1;
+	to.key   = from->key;
+	for(e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+		if((e->flags & E_MISN)) {
+			if((e->where == where0 || e->where == where1) && x->tests.exprs[e->to]) {
+				t->started[started_size++] = i;
+				t->started[started_size++] = e->to;
+			}
+			i++;
+			continue;
+		}
+		if((e->where != where0 && e->where != where1)
+			|| x->tests.watch_start[e->to] == x->tests.watch_start[e->to + 1]
+			|| !BitSetHas(t->state, e->to) == !(e->flags & E_SET)) continue;
+		if((e->flags & E_SET)) BitSetAdd(t->state, e->to);
+		else BitSetRemove(t->state, e->to);
+		to.key.a ^= x->zobrist[e->to].a;
+		to.key.b ^= x->zobrist[e->to].b;
+		t->undo[undo_size++] = e->to;
+	}
+	while(started_size) {
+		started_size -= 2;
+		m = t->started[started_size + 1];
+		if(ExprEvaluate(x->tests.exprs[m], t->state)) continue;
+		i = t->started[started_size];
+		if(t->broken_depth[i] == -1 || to.depth < t->broken_depth[i]) t->broken_depth[i] = to.depth;
+		t->broken_count[i]++;
+	}
+	if(!undo_size) return;
+	if(shard_add(x, t, &to)) {
+		memcpy(t->item, &to, sizeof to);
+		BitSetSave(t->state, t->item + sizeof to);
+		WorkPush(q, t->item);
+	}
+	for(i = 0; i < undo_size; i++) {
+		if(BitSetHas(t->state, t->undo[i])) BitSetRemove(t->state, t->undo[i]);
+		else BitSetAdd(t->state, t->undo[i]);
+	}
+}
+
+/** Adds the state of item to the visited states; a state that was seen
+ before, but in more transitions, is explored again from here, so what's
+ explored doesn't depend on the order. The shards only split the locking;
+ explore_states is over all of them, counted by t.
+ @return	Whether it's to be explored; if there are explore_states states
+			already, a new one is not. */
+static int shard_add(struct Explorer *const x, struct Explore *const t, const struct ExploreItem *const item) {
+	const struct Key *const key = &item->key;
+	struct Shard *const s = x->shards + (key->b & (shards_size - 1));
+	struct Visit *v;
+	int i, is_new = 0;
+
+	pthread_mutex_lock(&s->lock);
+	if(!key->a && !key->b) {
+		if(s->zero_depth != -1) {
+			if((is_new = item->depth < s->zero_depth)) s->zero_depth = item->depth;
+		} else if((is_new = explorer_count(x, t))) {
+			s->zero_depth = item->depth;
+		}
+	} else if(s->size << 1 < s->capacity || shard_grow(x, s)) {
+		for(i = (int)(key->a & (s->capacity - 1)); ; i = (i + 1) & (s->capacity - 1)) {
+			v = s->visits + i;
+			if(v->key.a == key->a && v->key.b == key->b) {
+				if((is_new = item->depth < v->depth)) v->depth = item->depth;
+				break;
+			}
+			if(v->key.a || v->key.b) continue;
+			if((is_new = explorer_count(x, t))) {
+				v->key   = *key;
+				v->depth = item->depth;
+				s->size++;
+			}
+			break;
+		}
+	}
+	pthread_mutex_unlock(&s->lock);
+	return is_new ? -1 : 0;
+}
+
+/** Doubles the capacity of s, which is locked.
+ @return	Success; otherwise, the error is in x, and nothing is added. */
+static int shard_grow(struct Explorer *const x, struct Shard *const s) {
+	struct Visit *visits, *v, *end;
+	int i, e;
+
+	if(s->capacity > INT_MAX >> 1) {
+		e = ERANGE;
+	} else if(!(visits = calloc(s->capacity << 1, sizeof *visits))) {
+		e = errno;
+	} else {
+		for(v = s->visits, end = v + s->capacity; v < end; v++) {
+			if(!v->key.a && !v->key.b) continue;
+			for(i = (int)(v->key.a & ((s->capacity << 1) - 1)); visits[i].key.a || visits[i].key.b; i = (i + 1) & ((s->capacity << 1) - 1));
+			visits[i] = *v;
+		}
+		free(s->visits);
+		s->visits = visits;
+		s->capacity <<= 1;
+		return -1;
+	}
+	pthread_mutex_lock(&x->lock);
+	if(!x->errno_copy) x->errno_copy = e;
+	pthread_mutex_unlock(&x->lock);
+	return 0;
+}
+
+/** Counts a new state against explore_states in t; it only takes the lock
+ when t has used what it took, and then it takes a share of what's left, at
+ most explore_batch, so the threads run out at about the same time; once
+ there's nothing left, it doesn't ask again. It's locked inside a shard's
+ lock, and never the other way around.
+ @return	Whether there was room for it. */
+static int explorer_count(struct Explorer *const x, struct Explore *const t) {
+	int batch;
+
+	if(!t->reserved) {
+		if(t->is_spent) return 0;
+		pthread_mutex_lock(&x->lock);
+		batch = (explore_states - x->taken) / (x->threads << 1);
+		if(batch > explore_batch) batch = explore_batch;
+		else if(!batch && x->taken < explore_states) batch = 1;
+		if(batch) x->taken += batch;
+		else x->is_full = -1;
+		pthread_mutex_unlock(&x->lock);
+		if(!(t->reserved = batch)) {
+			t->is_spent = -1;
+			return 0;
+		}
+	}
+	t->reserved--;
+	t->states++;
+	return -1;
+}
+
+/** Xorshift, so it's the same everywhere.
+ @param seed	The state, which is not zero.
+ @return		[1, 2^32). */
+static unsigned long random_next(unsigned long *const seed) {
+	*seed ^= (*seed << 13) & 0xffffffffUL;
+	*seed ^= *seed >> 17;
+	*seed ^= (*seed << 5) & 0xffffffffUL;
+	return *seed;
+}
+
+/** Runs the crons on the game calendar for simulate_years from simulate_start
+ with all bits clear, and prints a timeline of when each starts and ends and
+ the bits that it changes on stdout. A cron can be activated on a day that is
+ in its window, if the components that aren't zero, and its enable test is
+ true, with a chance of random percent, drawn every such day; it starts after
+ pre_holdoff days, if the test is still true every day until then, otherwise
+ it's back to drawing. It runs for duration days, and then can't be activated
+ for post_holdoff days. The draws are from --seed, so it's the same every
+ time. It doesn't go a day at a time: each cron has a day that it's next
+ looked at, in a heap, and the days with nothing to do are skipped; on a day,
+ the crons are in order, so a cron sees what the ones before it did that day.
+ An enable test is only run again when a bit that it reads changes.
+ @return	Success. */
+static int simulate(void) {
+	struct Simulator s;
+	struct Run *run;
+	const struct Cron *cron;
+	struct Date end;
+	int c, r, never = 0, is_ok = -1;
+
+	s.set     = 0;
+	s.runs    = 0;
+	s.wakes   = 0;
+	s.seed    = (unsigned long)simulate_seed;
+	s.starts  = 0;
+	s.ends    = 0;
+	s.changes = 0;
+	if(!tests(&s.tests)) return 0;
+	if(!(s.set = BitSet(graph.bits_size))
+		|| !(s.runs = calloc(graph.crons_size ? graph.crons_size : 1, sizeof *s.runs))
+		|| !(s.wakes = malloc(sizeof *s.wakes * (graph.crons_size ? graph.crons_size : 1)))) {
+		fprintf(stderr, "Simulate: %s.\n", s.set ? strerror(errno) : BitSetError(0));
+		simulate_(&s);
+		return 0;
+	}
+	if(!(out = Out(stdout, out_buffer, sizeof out_buffer))) {
+		fprintf(stderr, "Out: %s.\n", OutError(0));
+		simulate_(&s);
+		return 0;
+	}
+	s.date     = simulate_start;
+	s.today    = date_day(&s.date);
+	end        = simulate_start;
+	end.year  += simulate_years;
+	s.end      = date_day(&end);
+	s.current  = -1;
+	for(c = 0; c < graph.crons_size; c++) {
+		r   = graph.misns_size + c;
+		run = s.runs + c;
+		run->is_enabled = !s.tests.exprs[r] || ExprEvaluate(s.tests.exprs[r], s.set);
+		run->wake = LONG_MAX;
+		run->heap = c;
+		s.wakes[c] = c;
+	}
+	for(c = 0; c < graph.crons_size; c++) simulate_idle(&s, c, s.today);
+
+	while(graph.crons_size && (run = s.runs + (c = s.wakes[0]))->wake < s.end) {
+		if(run->wake != s.today) {
+			s.today = run->wake;
+			day_date(s.today, &s.date);
+		}
+		s.current = c;
+		cron = graph.crons + c;
+		switch(run->state) {
+			case R_IDLE:
+				/* it's only woken on a day in its window while it's enabled */
+				if(cron->random > 0 && cron->random < 100
+					&& (int)(random_next(&s.seed) % 100) >= cron->random) {
+					simulate_idle(&s, c, s.today + 1);
+				} else if(cron->pre_holdoff > 0) {
+					run->state = R_PRE;
+					run->until = s.today + cron->pre_holdoff;
+					simulate_wake(&s, c, run->until);
+				} else {
+					simulate_fire(&s, c, C_START);
+				}
+				break;
+			case R_PRE:
+				/* it's woken early when it's no longer enabled */
+				if(!run->is_enabled) {
+					run->state = R_IDLE;
+					simulate_idle(&s, c, s.today + 1);
+				} else {
+					simulate_fire(&s, c, C_START);
+				}
+				break;
+			case R_ACTIVE:
+				simulate_fire(&s, c, C_END);
+				break;
+			case R_POST:
+				run->state = R_IDLE;
+				simulate_idle(&s, c, s.today + 1);
+				break;
+		}
+	}
+	if(!Out_(&out)) {
+		fprintf(stderr, "Out: %s.\n", OutError(0));
+		is_ok = 0;
+	}
+
+	if(is_ok) {
+		for(c = 0; c < graph.crons_size; c++) if(!s.runs[c].starts) never++;
+		printf("\n%ld days from %d-%02d-%02d with seed %d: %ld starts and %ld ends, and %ld bits changed; %d of %d crons never started:\n",
+			s.end - date_day(&simulate_start), simulate_start.year, simulate_start.month, simulate_start.day, simulate_seed,
+			s.starts, s.ends, s.changes, never, graph.crons_size);
+		for(c = 0; c < graph.crons_size; c++) {
+			if(!s.runs[c].starts) printf("cron%d\t%s\n", graph.crons[c].id, graph.crons[c].name);
+		}
+		if(ferror(stdout)) {
+			fprintf(stderr, "Simulate: %s.\n", strerror(errno));
+			is_ok = 0;
+		}
+	}
+	simulate_(&s);
+	return is_ok;
+}
+
+/** Frees what @see{simulate} made. */
+static void simulate_(struct Simulator *const s) {
+	free(s->runs);
+	free(s->wakes);
+	BitSet_(&s->set);
+	tests_(&s->tests);
+	s->runs  = 0;
+	s->wakes = 0;
+}
+
+/** Starts or ends cron c today: applies its effects, runs the enable tests
+ of the crons that read the bits that changed, and prints it. A cron with no
+ duration ends the day it starts. A cron that's waiting, or holding off
+ before it starts, is woken on its next turn when its test changes: today if
+ it's after the current cron, otherwise tomorrow. */
+static void simulate_fire(struct Simulator *const s, const int c, const enum Where where) {
+	const int r = graph.misns_size + c;
+	const struct Edge *e, *const end = graph.forward.edges + graph.forward.end[r];
+	const struct Cron *const cron = graph.crons + c;
+	struct Run *const run = s->runs + c, *watcher;
+	const int *w, *w_end;
+	int is_enabled;
+	long turn;
+
+	out_date(&s->date);
+	OutString(out, "\tcron");
+	OutInt(out, cron->id);
+	OutChar(out, '\t');
+	OutString(out, cron->name);
+	OutString(out, where == C_START ? "\tstart\t" : "\tend\t");
+	for(e = graph.forward.edges + graph.forward.start[r]; e < end; e++) {
+		if(e->where != where || (e->flags & E_MISN)
+			|| !BitSetHas(s->set, e->to) == !(e->flags & E_SET)) continue;
+		if((e->flags & E_SET)) BitSetAdd(s->set, e->to);
+		else BitSetRemove(s->set, e->to);
+		s->changes++;
+		OutString(out, (e->flags & E_SET) ? " b" : " !b");
+		OutInt(out, graph.bits[e->to].bit);
+		w_end = s->tests.watch + s->tests.watch_start[e->to + 1];
+		for(w = s->tests.watch + s->tests.watch_start[e->to]; w < w_end; w++) {
+			if(*w < graph.misns_size) continue;
+			watcher = s->runs + *w - graph.misns_size;
+			is_enabled = ExprEvaluate(s->tests.exprs[*w], s->set);
+			if(!is_enabled == !watcher->is_enabled) continue;
+			watcher->is_enabled = is_enabled;
+			turn = *w - graph.misns_size > s->current ? s->today : s->today + 1;
+			if(watcher->state == R_IDLE) {
+				simulate_idle(s, *w - graph.misns_size, turn);
+			} else if(watcher->state == R_PRE) {
+				simulate_wake(s, *w - graph.misns_size, is_enabled ? watcher->until : turn);
+			}
+		}
+	}
+	OutChar(out, '\n');
+	if(where == C_START) {
+		s->starts++;
+		run->starts++;
+		run->state = R_ACTIVE;
+		run->until = s->today + cron->duration;
+		if(cron->duration <= 0) simulate_fire(s, c, C_END);
+		else simulate_wake(s, c, run->until);
+	} else {
+		s->ends++;
+		if(cron->post_holdoff > 0) {
+			run->state = R_POST;
+			run->until = s->today + cron->post_holdoff;
+			simulate_wake(s, c, run->until);
+		} else {
+			run->state = R_IDLE;
+			simulate_idle(s, c, s->today + 1);
+		}
+	}
+}
+
+/** Cron c is waiting from day on; it's woken on the first day after that in
+ its window, if it's enabled. */
+static void simulate_idle(struct Simulator *const s, const int c, const long day) {
+	simulate_wake(s, c, s->runs[c].is_enabled ? simulate_window(s, graph.crons + c, day) : LONG_MAX);
+}
+
+/** Finds the first day from day that's in the window of cron; it jumps by
+ the component that's out, so it's a few steps a year at most.
+ @return	The day, or LONG_MAX if there's none before the end. */
+static long simulate_window(const struct Simulator *const s, const struct Cron *const cron, long day) {
+	struct Date d;
+
+	for( ; day < s->end; day = date_day(&d)) {
+		day_date(day, &d);
+		if(date_compare(&d, cron->first_year, cron->first_month, cron->first_day) < 0) {
+			if(cron->first_year > 0 && d.year != cron->first_year) {
+				d.year  = cron->first_year;
+				d.month = 1;
+				d.day   = 1;
+			} else if(cron->first_month > 0 && d.month != cron->first_month) {
+				d.month = cron->first_month;
+				d.day   = 1;
+			} else if(cron->first_day <= date_days(d.year, d.month)) {
+				d.day = cron->first_day;
+			} else {
+				date_month(&d);
+			}
+		} else if(date_compare(&d, cron->last_year, cron->last_month, cron->last_day) > 0) {
+			if(cron->last_year > 0 && d.year != cron->last_year) {
+				break;
+			} else if(cron->last_month > 0 && d.month != cron->last_month) {
+				d.year++;
+				d.month = 1;
+				d.day   = 1;
+			} else {
+				date_month(&d);
+			}
+		} else {
+			return day;
+		}
+	}
+	return LONG_MAX;
+}
+
+/** Sets the day that cron c is next looked at, and moves it in the heap. */
+static void simulate_wake(struct Simulator *const s, const int c, const long day) {
+	int i = s->runs[c].heap, j;
+
+	s->runs[c].wake = day;
+	for( ; i > 0 && simulate_before(s, c, s->wakes[j = (i - 1) >> 1]); i = j) {
+		s->wakes[i] = s->wakes[j];
+		s->runs[s->wakes[i]].heap = i;
+	}
+	for( ; (j = (i << 1) + 1) < graph.crons_size; i = j) {
+		if(j + 1 < graph.crons_size && simulate_before(s, s->wakes[j + 1], s->wakes[j])) j++;
+		if(!simulate_before(s, s->wakes[j], c)) break;
+		s->wakes[i] = s->wakes[j];
+		s->runs[s->wakes[i]].heap = i;
+	}
+	s->wakes[i] = c;
+	s->runs[c].heap = i;
+}
+
+/** @return	Whether cron a is looked at before cron b. */
+static int simulate_before(const struct Simulator *const s, const int a, const int b) {
+	return s->runs[a].wake < s->runs[b].wake || (s->runs[a].wake == s->runs[b].wake && a < b);
+}
+
+/** Compares d with the date, skipping the components that are zero or less,
+ so a window can be, eg, every March.
+ @return	Less than, equal to, or greater than zero. */
+static int date_compare(const struct Date *const d, const int year, const int month, const int day) {
+	if(year > 0 && d->year != year) return d->year < year ? -1 : 1;
+	if(month > 0 && d->month != month) return d->month < month ? -1 : 1;
+	if(day > 0 && d->day != day) return d->day < day ? -1 : 1;
+	return 0;
+}
+
+/** Goes to the first of next month. */
+static void date_month(struct Date *const d) {
+	d->day = 1;
+	if(++d->month <= 12) return;
+	d->month = 1;
+	d->year++;
+}
+
+/** Counts in days, with the year starting in March so the leap day is last;
+ only the differences mean anything.
+ @return	The days to d from 0000-03-01, Gregorian. */
+static long date_day(const struct Date *const d) {
+	const long y = (long)d->year - (d->month <= 2), era = (y >= 0 ? y : y - 399) / 400,
+		year = y - era * 400,
+		day = (153L * (d->month > 2 ? d->month - 3 : d->month + 9) + 2) / 5 + d->day - 1;
+
+	return era * 146097 + year * 365 + year / 4 - year / 100 + day;
+}
+
+/** Sets d to the date day days from 0000-03-01; the inverse of
+ @see{date_day}. */
+static void day_date(const long day, struct Date *const d) {
+	const long era = (day >= 0 ? day : day - 146096) / 146097, days = day - era * 146097,
+		year = (days - days / 1460 + days / 36524 - days / 146096) / 365,
+		yday = days - (365 * year + year / 4 - year / 100), m = (5 * yday + 2) / 153;
+
+	d->day   = (int)(yday - (153 * m + 2) / 5 + 1);
+	d->month = (int)(m < 10 ? m + 3 : m - 9);
+	d->year  = (int)(year + era * 400 + (d->month <= 2));
+}
+
+/** @return	The days in month of year, Gregorian. */
+static int date_days(const int year, const int month) {
+	static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	if(month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) return 29;
+	return days[month - 1];
+}
+
+/** Prints d as year-mm-dd on out. */
+static void out_date(const struct Date *const d) {
+	OutInt(out, d->year);
+	OutString(out, d->month < 10 ? "-0" : "-");
+	OutInt(out, d->month);
+	OutString(out, d->day < 10 ? "-0" : "-");
+	OutInt(out, d->day);
+}
+
+/** Sets d to the date in field, eg, 1177-01-16.
+ @return	Success. */
+static int read_date(struct Date *const d, const char *field) {
+	struct Date e;
+	char *end;
+
+	e.year = (int)strtol(field, &end, 10);
+	if(end == field || *end != '-') return 0;
+	e.month = (int)strtol(field = end + 1, &end, 10);
+	if(end == field || *end != '-' || e.month < 1 || e.month > 12) return 0;
+	e.day = (int)strtol(field = end + 1, &end, 10);
+	if(end == field || *end || e.day < 1 || e.day > date_days(e.year, e.month)) return 0;
+	*d = e;
+	return -1;
+}
+
+/** Sets focus to the misns, crons and bits within focus_depth edges of the
+ ones in focus_spec, by a breadth-first search over the edges that are
+ printed; forward is the way the arrows point. The vertices are numbered as
+ misns, crons, and then bits, and only the ones that are used are followed.
+ @return	Success. */
+static int focus_find(void) {
+	const int resources = graph.misns_size + graph.crons_size,
+		vertices = resources + graph.bits_size;
+	int *depth = 0, *queue = 0, *from_start = 0, *from = 0;
+	int head = 0, tail = 0, no = 0, v, u, r, i, is_ok = -1;
+	const struct Edge *e, *end;
+	const char *s;
+
+	if(!(focus = BitSet(vertices))) {
+		fprintf(stderr, "Focus: %s.\n", BitSetError(0));
+		return 0;
+	}
+	/* the misns that start or abort each misn, which is not indexed */
+	for(r = 0; r < resources; r++) {
+		for(e = graph.forward.edges + graph.forward.start[r]; e < graph.forward.edges + graph.forward.end[r]; e++) {
+			if((e->flags & E_MISN)) no++;
+		}
+	}
+	if(!(depth = malloc(sizeof *depth * (vertices ? vertices : 1)))
+		|| !(queue = malloc(sizeof *queue * (vertices ? vertices : 1)))
+		|| !(from_start = calloc(graph.misns_size + 1, sizeof *from_start))
+		|| !(from = malloc(sizeof *from * (no ? no : 1)))) {
+		fprintf(stderr, "Focus: %s.\n", strerror(errno));
+		free(from);
+		free(from_start);
+		free(queue);
+		free(depth);
+		return 0;
+	}
+	for(r = 0; r < resources; r++) {
+		for(e = graph.forward.edges + graph.forward.start[r]; e < graph.forward.edges + graph.forward.end[r]; e++) {
+			if((e->flags & E_MISN)) from_start[e->to + 1]++;
+		}
+	}
+	for(i = 0; i < graph.misns_size; i++) from_start[i + 1] += from_start[i];
+	for(r = 0; r < resources; r++) {
+		for(e = graph.forward.edges + graph.forward.start[r]; e < graph.forward.edges + graph.forward.end[r]; e++) {
+			if((e->flags & E_MISN)) from[from_start[e->to]++] = r;
+		}
+	}
+	for(i = graph.misns_size; i > 0; i--) from_start[i] = from_start[i - 1];
+	from_start[0] = 0;
+
+	/* the start */
+	for(v = 0; v < vertices; v++) depth[v] = -1;
+	for(s = focus_spec; is_ok && *s; s += *s == ',') {
+		if((v = focus_vertex(s, &s)) == -1) {
+			fprintf(stderr, "Focus: \"%s\" is not a misn, cron, or bit that was read, eg, misn128,bit6666.\n", focus_spec);
+			is_ok = 0;
+			break;
+		}
+		if(depth[v] != -1) continue;
+		depth[v] = 0;
+		queue[tail++] = v;
+	}
+
+	/* breadth-first */
+	while(is_ok && head < tail) {
+		v = queue[head++];
+		BitSetAdd(focus, v);
+		if(depth[v] >= focus_depth) continue;
+		if(v < resources) {
+			end = graph.forward.edges + graph.forward.end[v];
+			for(e = graph.forward.edges + graph.forward.start[v]; e < end; e++) {
+				if((e->flags & E_MISN)) {
+					if(is_focus_forward && graph.misns[e->to].is_used) focus_visit(depth, queue, &tail, v, e->to);
+				} else if(graph.bits[e->to].is_used
+					&& ((e->where == M_AVAILABLE || e->where == C_ENABLE) ? is_focus_backward : is_focus_forward)) {
+					focus_visit(depth, queue, &tail, v, resources + e->to);
+				}
+			}
+			if(is_focus_backward && v < graph.misns_size) {
+				for(i = from_start[v]; i < from_start[v + 1]; i++) {
+					u = from[i];
+					if(u < graph.misns_size ? graph.misns[u].is_used : graph.crons[u - graph.misns_size].is_used) focus_visit(depth, queue, &tail, v, u);
+				}
+			}
+		} else {
+			const int b = v - resources;
+			end = graph.reverse.edges + graph.reverse.end[b];
+			for(e = graph.reverse.edges + graph.reverse.start[b]; e < end; e++) {
+				u = e->to;
+				if(!(u < graph.misns_size ? graph.misns[u].is_used : graph.crons[u - graph.misns_size].is_used)) continue;
+				if((e->where == M_AVAILABLE || e->where == C_ENABLE) ? is_focus_forward : is_focus_backward) focus_visit(depth, queue, &tail, v, u);
+			}
+		}
+	}
+	if(is_ok) fprintf(stderr, "Focus: %d of %d vertices within %d of %s.\n", BitSetCount(focus), vertices, focus_depth, focus_spec);
+
+	free(from);
+	free(from_start);
+	free(queue);
+	free(depth);
+	return is_ok;
+}
+
+/** Puts u, a neighbour of v, on the queue if it's not been seen. */
+static void focus_visit(int *const depth, int *const queue, int *const ptail, const int v, const int u) {
+	if(depth[u] != -1) return;
+	depth[u] = depth[v] + 1;
+	queue[(*ptail)++] = u;
+}
+
+/** Reads one of "misn<id>," "cron<id>," or "bit<bit>" from spec.
+ @param pend	Set to after it.
+ @return	The vertex, as in @see{focus_find}, or -1 if there's no such one. */
+static int focus_vertex(const char *spec, const char **const pend) {
+	const int resources = graph.misns_size + graph.crons_size;
+	char *end;
+	long id;
+	int i;
+
+	*pend = spec;
+	if(!strncmp(spec, "misn", 4)) {
+		id = strtol(spec + 4, &end, 10);
+		i = graph_find((const char *)graph.misns, &misns, graph.misns_size, (int)id);
+	} else if(!strncmp(spec, "cron", 4)) {
+		id = strtol(spec + 4, &end, 10);
+		if((i = graph_find((const char *)graph.crons, &crons, graph.crons_size, (int)id)) != -1) i += graph.misns_size;
+	} else if(!strncmp(spec, "bit", 3)) {
+		id = strtol(spec + 3, &end, 10);
+		if((i = graph_find((const char *)graph.bits, &bits, graph.bits_size, (int)id)) != -1) i += resources;
+	} else {
+		return -1;
+	}
+	if(end == spec || (*end && *end != ',')) return -1;
+	*pend = end;
+	return i;
+}
+
+/** Binary search of size elements at base, in the order of s, for key.
+ @return	The index, or -1. */
+static int graph_find(const char *const base, const struct Store *const s, const int size, const int key) {
+	int lo = 0, hi = size - 1, mid, id;
+
+	while(lo <= hi) {
+		mid = lo + (hi - lo) / 2;
+		memcpy(&id, base + s->width * mid + s->id, sizeof id);
+		if(id == key) return mid;
+		if(id < key) lo = mid + 1;
+		else hi = mid - 1;
+	}
+	return -1;
+}
+
+/** only the most obvious! (most famous b6666) */
+static void cull_bits_reset_by_crons(void) {
+	struct BitSet *ignore_bits = BitSet(graph.bits_size), /* bit indices */
+		*available = BitSet(graph.bits_size),
+		*touched = BitSet(graph.misns_size); /* misn indices */
+	const struct Edge *r;
+	struct Edge *e, *f, *end;
+	unsigned lists;
+	int i, b;
+
+	free(emptied);
+	if(!(emptied = calloc(graph.misns_size ? graph.misns_size : 1, sizeof *emptied))) {
+		perror("cull_bits_reset_by_crons");
+		return;
+	}
+	if(!ignore_bits || !available || !touched) {
+		fprintf(stderr, "cull_bits_reset_by_crons: %s.\n", BitSetError(0));
+		BitSet_(&ignore_bits);
+		BitSet_(&available);
+		BitSet_(&touched);
+		return;
+	}
+	/* first we must get the bits reset by crons */
+	for(i = 0; i < graph.crons_size; i++) {
+		struct Cron *const cron = graph.crons + i;
+		const int r = graph.misns_size + i;
+		const struct Edge *enable, *reset;
+
+		if(!cron->is_used) continue;
+		if(degree(&graph.forward, r, C_ENABLE, E_SET) != 1) continue;
+		if(degree(&graph.forward, r, C_ENABLE, 0) != 0) continue;
+		if(degree(&graph.forward, r, C_START, 0) + degree(&graph.forward, r, C_END, 0) != 1) continue;
+		if(degree(&graph.forward, r, C_START, E_SET) != 0 || degree(&graph.forward, r, C_END, E_SET) != 0) continue;
+		enable = first(&graph.forward, r, C_ENABLE, E_SET);
+		if(!(reset = first(&graph.forward, r, C_START, 0))) reset = first(&graph.forward, r, C_END, 0);
+		/* match */
+		if(enable->to != reset->to) continue;
+		BitSetAdd(ignore_bits, enable->to);
+		cron->is_used = 0; /* we don't care about the cron */
+		stats.crons_culled++;
+	}
+	/* misn's available set bits, than it can safely be ignored */
+	for(i = 0; i < graph.misns_size; i++) cluster_bits(available, i, M_AVAILABLE, E_SET);
+	BitSetDifference(ignore_bits, available);
+	fprintf(stderr, "Cron ignore bits: [");
+	for(b = BitSetNext(ignore_bits, 0); b != -1; b = BitSetNext(ignore_bits, b + 1)) fprintf(stderr, " %d", graph.bits[b].bit);
+	fprintf(stderr, " ]\n");
+
+	/* only the misns that mention an ignored bit, by the reverse index */
+	for(b = BitSetNext(ignore_bits, 0); b != -1; b = BitSetNext(ignore_bits, b + 1)) {
+		for(r = graph.reverse.edges + graph.reverse.start[b]; r < graph.reverse.edges + graph.reverse.end[b]; r++) {
+			if(r->to < graph.misns_size) BitSetAdd(touched, r->to);
+		}
+	}
+	/* delete all their bits that are in ignore_bits in one pass */
+	for(i = BitSetNext(touched, 0); i != -1; i = BitSetNext(touched, i + 1)) {
+		if(!graph.misns[i].is_used) continue;
+		lists = misn_lists(i);
+		end = graph.forward.edges + graph.forward.end[i];
+		for(e = f = graph.forward.edges + graph.forward.start[i]; e < end; e++) {
+			if(!(e->flags & E_MISN) && BitSetHas(ignore_bits, e->to)) continue;
+			*f++ = *e;
+		}
+		graph.forward.end[i] = f - graph.forward.edges;
+		emptied[i] = (unsigned short)(lists & ~misn_lists(i));
+	}
+	/* also delete the bits from bits, and the misns from their reverse */
+	for(b = BitSetNext(ignore_bits, 0); b != -1; b = BitSetNext(ignore_bits, b + 1)) {
+		graph.bits[b].is_used = 0;
+		stats.bits_culled++;
+		end = graph.reverse.edges + graph.reverse.end[b];
+		for(e = f = graph.reverse.edges + graph.reverse.start[b]; e < end; e++) {
+			if(e->to < graph.misns_size && graph.misns[e->to].is_used) continue;
+			*f++ = *e;
+		}
+		graph.reverse.end[b] = f - graph.reverse.edges;
+	}
+
+	BitSet_(&touched);
+	BitSet_(&available);
+	BitSet_(&ignore_bits);
+}
+
+/** nodes who's out degrees are zero are useless */
+static void cull_misns_out_degree_zero(void) {
+	const struct Edge *e;
+	int i;
+
+	for(i = 0; i < graph.misns_size; i++) {
+		struct Misn *const misn = graph.misns + i;
+		int no = 0;
+		if(!misn->is_used) continue;
+		for(e = graph.forward.edges + graph.forward.start[i]; e < graph.forward.edges + graph.forward.end[i]; e++) {
+			if(!(e->flags & E_MISN)) no++;
+		}
+		if(no) continue;
+		misn->is_used = 0;
+		stats.misns_culled++;
+		fprintf(stderr, "Misn%d has zero out-degree; it has been repressed.\n", misn->id);
+	}
+}
+
+/** Merges the misns that have the same topology. Every misn is hashed once and
+ only compared with the earlier misns in the same bucket, so it's about linear.
+ The first misn of a topology absorbs all the later ones. */
+static void merge_misns(void) {
+	struct Misn *misn, *nisn;
+	int *head, *next, *rep, buckets = 1, bucket, m, n;
+	const int misns_size = graph.misns_size;
+	char temp[128];
+
+	while(buckets < misns_size) buckets <<= 1;
+	if(!(head = malloc(sizeof(int) * (buckets + 2 * misns_size)))) {
+		perror("merge_misns");
+		return;
+	}
+	next = head + buckets;
+	rep  = next + misns_size;
+	for(n = 0; n < buckets; n++) head[n] = -1;
+
+	for(m = 0; m < misns_size; m++) {
+		misn = graph.misns + m;
+		rep[m] = -1;
+		if(!misn->is_used) continue;
+		bucket = misn_hash(m) & (buckets - 1);
+		next[m] = head[bucket];
+		for(n = next[m]; n != -1; n = next[n]) {
+			if(!misn_compare(n, m)) break;
+		}
+		if(n == -1) {
+			/* first of its kind */
+			head[bucket] = rep[m] = m;
+			continue;
+		}
+		rep[m] = n;
+		nisn = graph.misns + n;
+		/* the name is cut like snprintf(temp, sizeof temp, ...) would */
+		sprintf(temp, "\\n%d: ", misn->id);
+		strncat(temp, misn->name, sizeof temp - strlen(temp) - 1);
+		strncat(nisn->name, temp, misn_name_size - strlen(nisn->name) - 1);
+		misn->is_used = 0;
+		stats.misns_merged++;
+		fprintf(stderr, "Misn%d merged with Misn%d.\n", misn->id, nisn->id);
+	}
+
+	/* head is no longer needed, and is big enough for the order */
+	merge_sorted(rep, head);
+	free(head);
+}
+
+/** The old merge compared every pair of misns that were still used, and each
+ comparison sorted the clusters of both as far as the first that differed; the
+ rest were printed in the order they were read. This works out which clusters
+ that left sorted, in sorted_clusters, so the output stays the same.
+ @param rep		[misns] The misn that each merged with, itself if it was
+				the first of its kind, or -1 if it wasn't used.
+ @param order	[misns] Temporary. */
+static void merge_sorted(const int *const rep, int *const order) {
+	int *equal, size = 0, i, j, p, s, reps, merged_max;
+
+	free(sorted_clusters);
+	if(!(sorted_clusters = calloc(graph.misns_size ? graph.misns_size : 1, 1))
+		|| !(equal = malloc(sizeof(int) * (graph.misns_size ? graph.misns_size : 1)))) {
+		perror("merge_misns");
+		free(sorted_clusters);
+		sorted_clusters = 0;
+		return;
+	}
+	for(i = 0; i < graph.misns_size; i++) if(rep[i] != -1) order[size++] = i;
+	qsort(order, size, sizeof *order, (ListMetric)&misn_order);
+	/* equal[i] is how many clusters order[i - 1] and order[i] share */
+	for(i = 1; i < size; i++) misn_cluster_compare(order[i - 1], order[i], equal + i);
+	/* misn s and m were compared if the earlier of them was first of its kind
+	 and the later hadn't been merged into something before that; if they
+	 share p clusters, s has cluster p sorted */
+	for(p = 0; p < misn_helper_size; p++) {
+		for(i = 0; i < size; i = j) {
+			reps = 0;
+			merged_max = -1;
+			for(j = i; j < size && (j == i || equal[j] >= p); j++) {
+				if(rep[order[j]] == order[j]) reps++;
+				else if(rep[order[j]] > merged_max) merged_max = rep[order[j]];
+			}
+			for(s = i; s < j; s++) {
+				if(rep[order[s]] != order[s]) continue;
+				if(reps >= 2 || merged_max >= order[s]) sorted_clusters[order[s]] = (unsigned char)(p + 1);
+			}
+		}
+	}
+	free(equal);
+}
+
+/** Prints the forward edges of resource r, which is printed as label vertex.
+ Edges from a test go into the node, the others come out of the port. The
+ clusters that @see{merge_sorted} says were sorted are printed by index, the
+ others in the order that they were read. */
+static void print_edges(const int r, const char *const label, const int vertex) {
+	const struct Edge *e, *f, *g, *first, *next,
+		*const end = graph.forward.edges + graph.forward.end[r];
+
+	for(first = graph.forward.edges + graph.forward.start[r]; first < end; first = f) {
+		for(f = first + 1; f < end && f->where == first->where && f->flags == first->flags; f++);
+		if(r < graph.misns_size && !(first->flags & E_MISN) && sorted_clusters
+			&& first->where < sorted_clusters[r]) {
+			print_edge_range(first, f, label, vertex, 0);
+			continue;
+		}
+		/* a test is a few edges, so the next by rank is found by looking */
+		for(g = 0; ; g = next) {
+			for(next = 0, e = first; e < f; e++) {
+				if(g && (e->rank < g->rank || (e->rank == g->rank && e <= g))) continue;
+				if(!next || e->rank < next->rank) next = e;
+			}
+			if(!next) break;
+			print_edge_range(next, next + 1, label, vertex, 0);
+		}
+	}
+}
+
+/** Prints the edges [e, end) from label vertex. If is_raw, the edges are to
+ the bit numbers and misn ids, not indices into the graph, and the misns are
+ not known, so they are all printed. */
+static void print_edge_range(const struct Edge *e, const struct Edge *const end, const char *const label, const int vertex, const int is_raw) {
+	for( ; e < end; e++) {
+		if((e->flags & E_MISN) && !is_raw && !graph.misns[e->to].is_used) continue;
+		/* both ends have to be in the focus */
+		if(focus && !is_raw && !BitSetHas(focus, (e->flags & E_MISN) ? e->to : graph.misns_size + graph.crons_size + e->to)) continue;
+		stats.edges_emitted++;
+		if((e->flags & E_MISN)) {
+			/* edges that start automatically */
+			OutString(out, label);
+			OutInt(out, vertex);
+			OutChar(out, ':');
+			OutString(out, where_name[e->where]);
+			OutString(out, " -> misn");
+			OutInt(out, is_raw ? e->to : graph.misns[e->to].id);
+			OutString(out, (e->flags & E_SET) ? gv_misn : gv_not_misn);
+		} else if(e->where == M_AVAILABLE || e->where == C_ENABLE) {
+			/* test expression -- edge incident to node */
+			OutString(out, "bit");
+			OutInt(out, is_raw ? e->to : graph.bits[e->to].bit);
+			OutString(out, " -> ");
+			OutString(out, label);
+			OutInt(out, vertex);
+			OutString(out, (e->flags & E_SET) ? gv_end : gv_not_bit);
+		} else {
+			/* set expression */
+			OutString(out, label);
+			OutInt(out, vertex);
+			OutChar(out, ':');
+			OutString(out, where_name[e->where]);
+			OutString(out, " -> bit");
+			OutInt(out, is_raw ? e->to : graph.bits[e->to].bit);
+			OutString(out, (e->flags & E_SET) ? gv_end : gv_not_bit);
+		}
+	}
+}
+
+/** Prints the GraphViz of the inputs at paths, or stdin, one record at a
+ time as they are read, so the memory doesn't grow with the input and the
+ output can be piped as it goes. There is no culling or merging, a misn or cron
+ that is read twice is printed twice, and the bit nodes are at the end.
+ @return	Success. */
+static int stream(char **const paths, const int paths_size) {
+	struct List *edges = 0;
+	struct Load l;
+	struct Tsv *tsv = 0;
+	struct Bit *bit;
+	struct Misn m;
+	struct Cron c;
+	struct MisnClusters mc;
+	struct CronClusters cc;
+	FILE *fp;
+	char *e;
+	int i, is_ok = -1;
+
+	if(!(edges = List(sizeof(struct Edge)))) {
+		fprintf(stderr, "Stream: %s.\n", ListError(0));
+		return 0;
+	}
+	setvbuf(stdout, 0, _IONBF, 0);
+	if(!(out = Out(stdout, out_buffer, sizeof out_buffer))) {
+		fprintf(stderr, "Out: %s.\n", OutError(0));
+		List_(&edges);
+		return 0;
+	}
+	OutString(out, "digraph misn {\nrankdir = \"LR\";\n\n");
+	for(i = 0; is_ok && (i < paths_size || !i); i++) {
+		memset(&l, 0, sizeof l);
+		l.path = i < paths_size && strcmp(paths[i], "-") ? paths[i] : 0;
+		if(!l.path) {
+			fp = stdin;
+		} else if(!(fp = fopen(l.path, "rb"))) {
+			fprintf(stderr, "%s: %s.\n", l.path, strerror(errno));
+			is_ok = 0;
+			break;
+		}
+		if(!(tsv = Tsv(fp))) {
+			fprintf(stderr, "Input: %s.\n", TsvError(0));
+			is_ok = 0;
+		}
+		while(is_ok && TsvNext(tsv)) {
+			switch(decode(&l, tsv, &m, &c)) {
+				case T_MISN:
+					stats.misns_read++;
+					stats.nodes_emitted++;
+					OutString(out, "misn");
+					OutInt(out, m.id);
+					OutString(out, " [shape=Mrecord style=filled fillcolor=\"#1111EE5f\" label=\"{");
+					OutInt(out, m.id);
+					OutString(out, ": ");
+					OutString(out, m.name);
+					OutString(out, "|{<accept>accept|<refuse>refuse}|<ship>ship|{<success>success|<failure>failure|<abort>abort}}\"];\n");
+					memset(&mc, 0, sizeof mc);
+					stream_resource(&m, &mc, misn_helper, misn_helper_size, "misn", m.id, edges);
+					break;
+				case T_CRON:
+					stats.crons_read++;
+					stats.nodes_emitted++;
+					OutString(out, "cron");
+					OutInt(out, c.id);
+					OutString(out, " [shape=record style=filled fillcolor=\"#EE11115f\" label=\"{");
+					OutInt(out, c.id);
+					OutString(out, ": ");
+					OutString(out, c.name);
+					OutString(out, "|{<start>start|<end>end}}\"];\n");
+					memset(&cc, 0, sizeof cc);
+					stream_resource(&c, &cc, cron_helper, cron_helper_size, "cron", c.id, edges);
+					break;
+				default:
+					stats.rejected++;
+					break;
+			}
+			/* the clusters are only needed for the one record */
+			ListArena_(&clusters);
+			if(!(clusters = ListArena())) {
+				fprintf(stderr, "Stream: %s.\n", ListError(0));
+				is_ok = 0;
+			}
+		}
+		if((e = TsvError(tsv))) {
+			fprintf(stderr, "Input: %s.\n", e);
+			is_ok = 0;
+		}
+		Tsv_(&tsv);
+		if(l.path) fclose(fp);
+	}
+	OutChar(out, '\n');
+
+	/* the bits that were seen */
+	store_sort(&bits);
+	while((bit = ListIterate(bits.list))) {
+		stats.nodes_emitted++;
+		OutString(out, "bit");
+		OutInt(out, bit->bit);
+		OutString(out, " [label=\"");
+		OutInt(out, bit->bit);
+		OutString(out, "\" constraint=false shape=plain style=dotted fillcolor=\"#11EE115f\"];\n");
+	}
+	OutString(out, "\n}\n");
+
+	if(!Out_(&out)) {
+		fprintf(stderr, "Out: %s.\n", OutError(0));
+		is_ok = 0;
+	}
+	List_(&edges);
+	return is_ok;
+}
+
+/** Parses the clusters of reso into cl, which is zeroed, and prints its edges
+ in the order of the whole graph; edges is a temporary that is reused. */
+static void stream_resource(const void *const reso, void *const cl, const struct Helper *const helper, const int helper_size, const char *const label, const int id, struct List *const edges) {
+	struct Cluster *cluster;
+	struct Edge edge;
+	int i, k, *pi;
+
+	parse_resource(reso, cl, helper, helper_size);
+	ListClear(edges);
+	for(i = 0; i < helper_size; i++) {
+		edge.where = (unsigned char)helper[i].where;
+		edge.rank  = 0;
+		for(k = 0; k < 4; k++) {
+			if(k >= 2 && !helper[i].misn_cluster) break;
+			cluster = (struct Cluster *)((char *)cl + (k < 2 ? helper[i].bit_cluster : helper[i].misn_cluster));
+			edge.flags = (unsigned char)((k & 1 ? 0 : E_SET) | (k >= 2 ? E_MISN : 0));
+			while((pi = ListIterate(k & 1 ? cluster->clear : cluster->set))) {
+				edge.to = *pi;
+				ListAdd(edges, &edge);
+			}
+		}
+	}
+	ListSort(edges, (ListMetric)&edge_compare);
+	ListUnique(edges, (ListMetric)&edge_compare);
+	print_edge_range(ListGet(edges, 0), (struct Edge *)ListGet(edges, 0) + ListSize(edges), label, id, -1);
+}
+
+/** Reads all the inputs at paths, or stdin if there are none, into the
+ stores, and parses them; with more than one thread, the inputs are cut into
+ pieces so that one file is read by all of them.
+ @return	Success. */
+static int input(char **const paths, const int paths_size, const int threads) {
+	struct List *loads;
+	struct Load *l;
+	int i, changes = 0, is_cached = 0, is_error = 0;
+
+	if(!(loads = List(sizeof(struct Load)))) {
+		fprintf(stderr, "Input: %s.\n", ListError(0));
+		return 0;
+	}
+	if(cache_path && !cache_load()) is_error = -1;
+	for(i = 0; !is_error && (i < paths_size || !i); i++) {
+		const char *const path = i < paths_size && strcmp(paths[i], "-") ? paths[i] : 0;
+		if(!loads_add(loads, path, threads)) is_error = -1;
+	}
+	if(!is_error && !load_all(loads, threads)) is_error = -1;
+	/* the graph in the cache is only any good if the records line up */
+	if(!is_error && cache.records) {
+		if(cache_lines_up(loads, &changes)) {
+			is_cached = -1;
+		} else {
+			fprintf(stderr, "%s: the records don't line up with it; reading all of them.\n", cache_path);
+			memset(&graph, 0, sizeof graph);
+			cache_();
+			for(i = 0; i < ListSize(loads); i++) load_clear(ListGet(loads, i));
+			if(!load_all(loads, threads)) is_error = -1;
+		}
+	}
+	/* later inputs replace the ids of earlier ones */
+	for(i = 0; !is_error && i < ListSize(loads); i++) {
+		if(!load_commit(ListGet(loads, i), !is_cached)) is_error = -1;
+	}
+	if(!is_error && cache_path && !cache_fresh(loads)) is_error = -1;
+	if(is_cached) {
+		/* the graph is the cache's, and it has to be freed with it */
+		graph.snapshot      = cache.data;
+		graph.snapshot_size = cache.size;
+		graph.is_mapped     = cache.is_mapped;
+		cache.data = 0;
+		cache.is_kept = changes <= cache.records_size / cache_rewrite;
+		if(!is_error && changes && !cache_patch(loads)) is_error = -1;
+	} else if(!graph.snapshot) {
+		/* it may have pointed into the cache, which is going */
+		memset(&graph, 0, sizeof graph);
+	}
+	while((l = ListIterate(loads))) load_(l);
+	List_(&loads);
+	if(is_error) return 0;
+	if(is_cached) return -1;
+
+	/* in order of id */
+	store_sort(&misns);
+	store_sort(&crons);
+
+	if(cache_path && !cache_resolve()) return 0;
+	return parse_resources();
+}
+
+/** Adds the Loads for the input at path. In one piece, it is read as a
+ stream; otherwise, it is read all at once and cut up after newlines into
+ about equal pieces, each knowing the line it starts on.
+ @param path	The file, or null for stdin.
+ @return		Success. */
+static int loads_add(struct List *const loads, const char *const path, const int pieces) {
+	const size_t piece_min = 0x10000;
+	struct Load l;
+	char *text, *end, *cut, *newline;
+	size_t size;
+	int no, is_first = -1;
+
+	memset(&l, 0, sizeof l);
+	l.path = path;
+	/* with -c, it may have to be read again */
+	if(pieces <= 1 && !cache_path) {
+		if(!load(&l)) return 0;
+		if(!ListAdd(loads, &l)) {
+			fprintf(stderr, "Input: %s.\n", ListError(loads));
+			load_(&l);
+			return 0;
+		}
+		return -1;
+	}
+	if(!read_all(path, &text, &size)) {
+		fprintf(stderr, "%s: %s.\n", path ? path : "Input", strerror(errno));
+		return 0;
+	}
+	no = size / piece_min < (size_t)pieces ? (int)(size / piece_min) : pieces;
+	if(no < 1) no = 1;
+	for(end = text + size, cut = text; is_first || cut < end; no--) {
+		l.text = cut;
+		/* cut after the newline after an equal share of what's left */
+		cut = no > 1 ? cut + (end - cut) / no : end;
+		if(cut < end && (newline = memchr(cut, '\n', end - cut))) cut = newline + 1;
+		else cut = end;
+		l.text_size = cut - l.text;
+		l.is_text_owner = is_first;
+		if(!load(&l) || !ListAdd(loads, &l)) {
+			fprintf(stderr, "Input: %s.\n", ListError(0));
+			load_(&l);
+			return 0;
+		}
+		/* count the lines for the next one */
+		for(newline = l.text; (newline = memchr(newline, '\n', cut - newline)); newline++) l.line++;
+		is_first = 0;
+	}
+	return -1;
+}
+
+/** Reads all of the file at path, or stdin if it's null, into *ptext, which
+ has a null after *psize bytes and must be freed.
+ @return	Success.
+ @throws	errno; nothing is printed. */
+static int read_all(const char *const path, char **const ptext, size_t *const psize) {
+	FILE *fp;
+	char *text = 0, *grow;
+	size_t size = 0, capacity = 0x100000, read;
+	int is_error = 0;
+
+	if(!path) fp = stdin;
+	else if(!(fp = fopen(path, "rb"))) return 0;
+	do {
+		if(!(grow = realloc(text, capacity + 1))) { errno = ENOMEM; is_error = -1; break; }
+		text = grow;
+		read = fread(text + size, 1, capacity - size, fp);
+		size += read;
+		if(size < capacity) break;
+		capacity <<= 1;
+	} while(read);
+	if(is_error || ferror(fp)) {
+		const int e = errno;
+		free(text);
+		if(path) fclose(fp);
+		errno = e;
+		return 0;
+	}
+	if(path) fclose(fp);
+	text[size] = '\0';
+	*ptext = text;
+	*psize = size;
+	return -1;
+}
+
+/** Adds size bytes at data to sum two different ways, so that it's very
+ unlikely that different bytes are the same. It goes a word at a time, and the
+ bytes that don't fill a word one at a time, so adding in pieces is the same as
+ adding all at once only if all but the last piece are a multiple of four. */
+static void sum_add(struct Hash *const sum, const void *const data, const size_t size) {
+	const unsigned char *s = data, *const end = s + size;
+	unsigned a = sum->a, b = sum->b, w;
+
+	for( ; s + 4 <= end; s += 4) {
+		w = (unsigned)s[0] | (unsigned)s[1] << 8 | (unsigned)s[2] << 16 | (unsigned)s[3] << 24;
+		a = ((a ^ w) * 16777619u) & 0xffffffffu;
+		b = ((b + w) * 2654435761u) & 0xffffffffu;
+		b ^= b >> 15;
+	}
+	for( ; s < end; s++) {
+		a = ((a ^ *s) * 16777619u) & 0xffffffffu;
+		b = ((b + *s) * 2654435761u) & 0xffffffffu;
+	}
+	sum->a = a;
+	sum->b = b;
+}
+
+/** Hashes the bytes of the current record of tsv with @see{sum_add}; it has
+ to be faster than decoding the record for the cache to help. */
+static void record_hash(struct Tsv *const tsv, struct Hash *const hash) {
+	const char *record;
+	size_t size;
+
+	record = TsvRecord(tsv, &size);
+	hash->a = 2166136261u;
+	hash->b = (unsigned)misn_fields_size;
+	sum_add(hash, record, size);
+	hash->a ^= (unsigned)size;
+}
+
+/** Initialises the Lists of the Load; the rest is set.
+ @return	Success. */
+static int load(struct Load *const l) {
+	l->error = 0;
+	if(!(l->misns = List(sizeof(struct Misn)))
+		|| !(l->crons = List(sizeof(struct Cron)))
+		|| !(l->notes = List(sizeof(struct Note)))
+		|| !(l->order = List(sizeof(unsigned char)))
+		|| !(l->hashes = List(sizeof(struct Hash)))) {
+		fprintf(stderr, "%s: %s.\n", l->path ? l->path : "Input", ListError(0));
+		load_(l);
+		return 0;
+	}
+	return -1;
+}
+
+static void load_(struct Load *const l) {
+	if(l->is_text_owner) free(l->text);
+	l->text = 0;
+	l->is_text_owner = 0;
+	List_(&l->misns);
+	List_(&l->crons);
+	List_(&l->notes);
+	List_(&l->order);
+	List_(&l->hashes);
+}
+
+/** Forgets what was read in l, so it can be read again. */
+static void load_clear(struct Load *const l) {
+	ListClear(l->misns);
+	ListClear(l->crons);
+	ListClear(l->notes);
+	ListClear(l->order);
+	ListClear(l->hashes);
+	l->reused   = 0;
+	l->rejected = 0;
+	l->error    = 0;
+}
+
+static void cache_(void) {
+	if(cache.data) {
+#ifndef _WIN32
+		if(cache.is_mapped) munmap(cache.data, cache.size);
+		else
+#endif
+		free(cache.data);
+	}
+	Map_(&cache.index);
+	free(cache.next);
+	free(cache.fresh);
+	memset(&cache, 0, sizeof cache);
+}
+
+/** Maps the file at cache_path, if there is one, so @see{cache_get} can find
+ the records in it, and points the graph at the graph in it, for
+ @see{cache_lines_up}; all of it is checked against the sum in the header.
+ @return	Success; a missing, old, or damaged cache is not an error, it's as
+			if there were none. */
+static int cache_load(void) {
+	struct CacheHeader head;
+	struct Hash sum = { 0, 0 };
+	const char *e = 0;
+	const int *pfirst;
+	int i, vertices;
+
+	if(!map_file(cache_path, &cache.data, &cache.size, &cache.is_mapped)) {
+		if(errno != ENOENT) fprintf(stderr, "%s: %s; ignoring it.\n", cache_path, strerror(errno));
+		cache_();
+		return -1;
+	}
+	if(cache.size < sizeof head) {
+		e = "not a cache";
+	} else {
+		memcpy(&head, cache.data, sizeof head);
+		if(memcmp(head.magic, "PngC", sizeof head.magic) || head.version != cache_version) {
+			e = "not a cache from this version";
+		} else if(head.records < 0
+			|| (size_t)head.records > (cache.size - sizeof head) / sizeof(struct CacheRecord)
+			|| head.graph < sizeof head + sizeof(struct CacheRecord) * head.records
+			|| head.graph > cache.size || head.graph & 7) {
+			e = "truncated";
+		} else {
+			sum_add(&sum, cache.data + sizeof head, cache.size - sizeof head);
+			if(sum.a != head.sum.a || sum.b != head.sum.b) e = "damaged";
+		}
+	}
+	if(!e && !graph_map(cache.data + head.graph, cache.size - head.graph, cache_path)) e = "the graph in it is no good";
+	if(!e) {
+		cache.records      = (const struct CacheRecord *)(cache.data + sizeof head);
+		cache.records_size = head.records;
+		vertices = graph.misns_size + graph.crons_size;
+		for(i = 0; i < cache.records_size; i++) {
+			if(cache.records[i].resource < -1 || cache.records[i].resource >= vertices) {
+				e = "the records are out of range";
+				break;
+			}
+		}
+	}
+	if(e) {
+		fprintf(stderr, "%s: %s; ignoring it.\n", cache_path, e);
+		memset(&graph, 0, sizeof graph);
+		cache_();
+		return -1;
+	}
+	if(!(cache.index = Map()) || !(cache.next = malloc(sizeof(int) * (head.records ? head.records : 1)))) {
+		fprintf(stderr, "%s: %s.\n", cache_path, cache.index ? strerror(errno) : MapError(0));
+		memset(&graph, 0, sizeof graph);
+		cache_();
+		return 0;
+	}
+	/* chain the records that have the same hash.a */
+	for(i = 0; i < cache.records_size; i++) {
+		cache.next[i] = (pfirst = MapGet(cache.index, (int)cache.records[i].hash.a)) ? *pfirst : -1;
+		if(!MapPut(cache.index, (int)cache.records[i].hash.a, i)) {
+			fprintf(stderr, "%s: %s.\n", cache_path, MapError(cache.index));
+			memset(&graph, 0, sizeof graph);
+			cache_();
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/** @return	The record in the cache that hashed to hash when it was saved, or
+			-1. */
+static int cache_get(const struct Hash *const hash) {
+	const int *pfirst;
+	int i;
+
+	if(!(pfirst = MapGet(cache.index, (int)hash->a))) return -1;
+	for(i = *pfirst; i != -1; i = cache.next[i]) {
+		if(cache.records[i].hash.a == hash->a && cache.records[i].hash.b == hash->b) return i;
+	}
+	return -1;
+}
+
+/** Checks that the records that were read in loads would make the graph that
+ is in the cache, but for the misns and crons that were decoded: every record
+ is where it was, and it hashes the same, or it's a misn or cron that has the
+ id of the one it became in the graph, or neither it nor the one before it
+ became anything.
+ @param pchanges	Gets the number of records that don't hash the same.
+ @return			Whether the graph can be patched with @see{cache_patch}. */
+static int cache_lines_up(struct List *const loads, int *const pchanges) {
+	const struct Load *l;
+	const struct CacheRecord *was;
+	const struct Hash *hash;
+	const unsigned char *type;
+	int i, k, h, m, c, id = 0, p = 0;
+
+	*pchanges = 0;
+	for(i = 0; i < ListSize(loads); i++) {
+		l = ListGet(loads, i);
+		if(l->error) return 0;
+		for(h = m = c = k = 0; k < ListSize(l->order); k++) {
+			type = ListGet(l->order, k);
+			if(*type == T_NOTE) continue;
+			if(p >= cache.records_size || !(hash = ListGet(l->hashes, h++))) return 0;
+			was = cache.records + p++;
+			if(*type == T_MISN) id = ((struct Misn *)ListGet(l->misns, m++))->id;
+			else if(*type == T_CRON) id = ((struct Cron *)ListGet(l->crons, c++))->id;
+			if(was->hash.a == hash->a && was->hash.b == hash->b) continue;
+			(*pchanges)++;
+			if(was->resource == -1) {
+				if(*type != T_REJECTED) return 0;
+			} else if(*type == T_MISN) {
+				if(was->resource >= graph.misns_size || graph.misns[was->resource].id != id) return 0;
+			} else if(*type == T_CRON) {
+				if(was->resource < graph.misns_size || graph.crons[was->resource - graph.misns_size].id != id) return 0;
+			} else {
+				/* it moved, or it's gone */
+				return 0;
+			}
+		}
+	}
+	return p == cache.records_size;
+}
+
+/** Puts the misns and crons that were decoded in loads, which
+ @see{cache_lines_up} found in the graph from the cache, in their places in
+ it, with their new edges. The bits that they bring in are added, and the bits
+ that nothing is left pointing at are taken out, so it's the graph that
+ @see{freeze} would have made. The records are written over in the mapping;
+ the edges and the bits are allocated.
+ @return	Success. */
+static int cache_patch(struct List *const loads) {
+	const int vertices = graph.misns_size + graph.crons_size;
+	struct List *edges = List(sizeof(struct Edge)); /* new, to bit ids */
+	struct List *added = List(sizeof(int)); /* bit ids not in the graph */
+	int *range = malloc(sizeof(int) * (vertices ? 2 * vertices : 1));
+	int *remap = malloc(sizeof(int) * (graph.bits_size ? graph.bits_size : 1));
+	struct Adjacency forward = { 0, 0, 0, 0 };
+	struct MisnClusters mc;
+	struct CronClusters cc;
+	struct Bit *new_bits = 0;
+	struct Load *l;
+	struct Misn *m;
+	struct Cron *c;
+	struct Edge *e, *f, *end;
+	int i, k, r, b, no, new_bits_size = 0, is_ok = -1;
+
+	if(!edges || !added || !range || !remap) {
+		fprintf(stderr, "%s: %s.\n", cache_path, edges && added ? strerror(errno) : ListError(0));
+		is_ok = 0;
+	}
+
+	/* the edges of the misns and crons that were decoded, from range[r] to
+	 range[vertices + r] in edges, or -1 for the ones that are kept */
+	for(r = 0; is_ok && r < 2 * vertices; r++) range[r] = -1;
+	for(i = 0; is_ok && i < ListSize(loads); i++) {
+		l = ListGet(loads, i);
+		for(k = 0; is_ok && (m = ListGet(l->misns, k)); k++) {
+			r = graph_find((char *)graph.misns, &misns, graph.misns_size, m->id);
+			memset(&mc, 0, sizeof mc);
+			parse_resource(m, &mc, misn_helper, misn_helper_size);
+			range[r] = ListSize(edges);
+			is_ok = cache_patch_edges(edges, (char *)&mc, misn_helper, misn_helper_size);
+			range[vertices + r] = ListSize(edges);
+		}
+		for(k = 0; is_ok && (c = ListGet(l->crons, k)); k++) {
+			r = graph.misns_size + graph_find((char *)graph.crons, &crons, graph.crons_size, c->id);
+			memset(&cc, 0, sizeof cc);
+			parse_resource(c, &cc, cron_helper, cron_helper_size);
+			range[r] = ListSize(edges);
+			is_ok = cache_patch_edges(edges, (char *)&cc, cron_helper, cron_helper_size);
+			range[vertices + r] = ListSize(edges);
+		}
+	}
+
+	/* the in-degree of the bits, without the edges that are replaced and
+	 with the new ones */
+	for(b = 0; is_ok && b < graph.bits_size; b++) remap[b] = graph.reverse.end[b] - graph.reverse.start[b];
+	for(r = 0; is_ok && r < vertices; r++) {
+		if(range[r] == -1) continue;
+		for(e = graph.forward.edges + graph.forward.start[r], end = graph.forward.edges + graph.forward.end[r]; e < end; e++) {
+			if(!(e->flags & E_MISN)) remap[e->to]--;
+		}
+	}
+	for(k = 0; is_ok && (e = ListGet(edges, k)); k++) {
+		if(e->flags & E_MISN) continue;
+		if((b = graph_find((char *)graph.bits, &bits, graph.bits_size, e->to)) != -1) remap[b]++;
+		else if(!ListAdd(added, &e->to)) {
+			fprintf(stderr, "%s: %s.\n", cache_path, ListError(added));
+			is_ok = 0;
+		}
+	}
+
+	/* the bits that are left and the ones that are added, in order of id;
+	 then remap goes from the old index to the new one */
+	if(is_ok && !(new_bits = malloc(sizeof *new_bits * (graph.bits_size + ListSize(added) + 1)))) {
+		fprintf(stderr, "%s: %s.\n", cache_path, strerror(errno));
+		is_ok = 0;
+	}
+	for(b = 0; is_ok && b < graph.bits_size; b++) {
+		if(remap[b] > 0) new_bits[new_bits_size++] = graph.bits[b];
+	}
+	for(k = 0; is_ok && k < ListSize(added); k++) {
+		new_bits[new_bits_size].is_used = -1;
+		new_bits[new_bits_size].bit     = *(int *)ListGet(added, k);
+		new_bits_size++;
+	}
+	if(is_ok) {
+		qsort(new_bits, new_bits_size, sizeof *new_bits, (ListMetric)&bit_compare_id);
+		for(no = 0, b = 0; b < new_bits_size; b++) {
+			if(!no || new_bits[no - 1].bit != new_bits[b].bit) new_bits[no++] = new_bits[b];
+		}
+		new_bits_size = no;
+		for(b = 0; b < graph.bits_size; b++) {
+			remap[b] = remap[b] > 0 ? graph_find((char *)new_bits, &bits, new_bits_size, graph.bits[b].bit) : -1;
+		}
+	}
+
+	/* the forward edges; the ones that are new are sorted like freeze does */
+	for(no = 0, r = 0; is_ok && r < vertices; r++) {
+		no += range[r] == -1 ? graph.forward.end[r] - graph.forward.start[r]
+			: range[vertices + r] - range[r];
+	}
+	if(is_ok && !adjacency(&forward, vertices, no)) is_ok = 0;
+	for(f = forward.edges, r = 0; is_ok && r < vertices; r++) {
+		forward.start[r] = f - forward.edges;
+		if(range[r] == -1) {
+			for(e = graph.forward.edges + graph.forward.start[r], end = graph.forward.edges + graph.forward.end[r]; e < end; e++, f++) {
+				*f = *e;
+				if(!(f->flags & E_MISN)) f->to = remap[f->to];
+			}
+		} else {
+			for(k = range[r]; k < range[vertices + r]; k++, f++) {
+				*f = *(struct Edge *)ListGet(edges, k);
+				if(!(f->flags & E_MISN)) f->to = graph_find((char *)new_bits, &bits, new_bits_size, f->to);
+			}
+			qsort(forward.edges + forward.start[r], f - (forward.edges + forward.start[r]), sizeof *f, (ListMetric)&edge_compare);
+		}
+		forward.end[r] = f - forward.edges;
+	}
+
+	/* the records go over the old ones */
+	for(i = 0; is_ok && i < ListSize(loads); i++) {
+		l = ListGet(loads, i);
+		for(k = 0; (m = ListGet(l->misns, k)); k++) {
+			memcpy(graph.misns + graph_find((char *)graph.misns, &misns, graph.misns_size, m->id), m, sizeof *m);
+		}
+		for(k = 0; (c = ListGet(l->crons, k)); k++) {
+			memcpy(graph.crons + graph_find((char *)graph.crons, &crons, graph.crons_size, c->id), c, sizeof *c);
+		}
+	}
+	if(is_ok) {
+		graph.forward    = forward;
+		graph.bits       = new_bits;
+		graph.bits_size  = new_bits_size;
+		graph.is_patched = -1;
+		new_bits = 0;
+		forward.start = 0;
+		forward.edges = 0;
+		is_ok = graph_reverse();
+	}
+	adjacency_(&forward);
+	free(new_bits);
+	free(remap);
+	free(range);
+	List_(&added);
+	List_(&edges);
+	return is_ok;
+}
+
+/** Adds the edges of the clusters cl to edges in the order @see{freeze} does,
+ but with the ids of the bits in to, since they may not be in the graph yet.
+ @return	Success. */
+static int cache_patch_edges(struct List *const edges, const char *const cl, const struct Helper *const helper, const int helper_size) {
+	const struct Cluster *cluster;
+	struct Edge edge;
+	int *pi, i, k, rank;
+
+	for(i = 0; i < helper_size; i++) {
+		edge.where = (unsigned char)helper[i].where;
+		/* bits set, bits clear, misns set, misns clear */
+		for(k = 0; k < 4; k++) {
+			if(k >= 2 && !helper[i].misn_cluster) break;
+			cluster = (const struct Cluster *)(cl + (k < 2 ? helper[i].bit_cluster : helper[i].misn_cluster));
+			edge.flags = (unsigned char)((k & 1 ? 0 : E_SET) | (k >= 2 ? E_MISN : 0));
+			for(rank = 0; (pi = ListIterate(k & 1 ? cluster->clear : cluster->set)); ) {
+				/* misns that were never read are left out */
+				if(k >= 2 && (edge.to = graph_find((char *)graph.misns, &misns, graph.misns_size, *pi)) == -1) continue;
+				if(k < 2) edge.to = *pi;
+				edge.rank = (unsigned short)(rank < USHRT_MAX ? rank++ : USHRT_MAX);
+				if(!ListAdd(edges, &edge)) {
+					fprintf(stderr, "%s: %s.\n", cache_path, ListError(edges));
+					return 0;
+				}
+			}
+		}
+	}
+	return -1;
+}
+
+/** Lists the hashes of the records that were read in loads, in order, in
+ cache.fresh, for @see{cache_save}. If they lined up with the cache, each
+ became the same resource as before; otherwise, a misn is its id and a cron
+ is minus its id until @see{cache_resolve}.
+ @return	Success. */
+static int cache_fresh(struct List *const loads) {
+	const struct Load *l;
+	const struct Hash *hash;
+	const unsigned char *type;
+	struct CacheRecord *f;
+	int i, k, h, m, c, size = 0;
+
+	for(i = 0; i < ListSize(loads); i++) size += ListSize(((struct Load *)ListGet(loads, i))->hashes);
+	if(!(cache.fresh = malloc(sizeof *cache.fresh * (size ? size : 1)))) {
+		fprintf(stderr, "%s: %s.\n", cache_path, strerror(errno));
+		return 0;
+	}
+	cache.fresh_size = size;
+	for(f = cache.fresh, i = 0; i < ListSize(loads); i++) {
+		l = ListGet(loads, i);
+		for(h = m = c = k = 0; k < ListSize(l->order); k++) {
+			type = ListGet(l->order, k);
+			if(*type == T_NOTE) continue;
+			/* there's a hash for every record unless it ran out of memory */
+			if(!(hash = ListGet(l->hashes, h++))) return -1;
+			f->hash = *hash;
+			if(cache.records) f->resource = cache.records[f - cache.fresh].resource;
+			else if(*type == T_MISN) f->resource = ((struct Misn *)ListGet(l->misns, m++))->id;
+			else if(*type == T_CRON) f->resource = -((struct Cron *)ListGet(l->crons, c++))->id;
+			else f->resource = 0;
+			f++;
+		}
+	}
+	return -1;
+}
+
+/** Changes the ids in cache.fresh to the resources they became, once the
+ stores are sorted; going from the end, a record with an id that's already
+ been seen was replaced, and became nothing.
+ @return	Success. */
+static int cache_resolve(void) {
+	const int misns_size = store_size(&misns);
+	const int *pindex;
+	char *is_taken;
+	int p, id, r;
+
+	if(!(is_taken = calloc(misns_size + store_size(&crons) + 1, 1))) {
+		fprintf(stderr, "%s: %s.\n", cache_path, strerror(errno));
+		return 0;
+	}
+	for(p = cache.fresh_size - 1; p >= 0; p--) {
+		id = cache.fresh[p].resource;
+		r = -1;
+		if(id > 0 && (pindex = MapGet(misns.index, id))) r = *pindex;
+		else if(id < 0 && (pindex = MapGet(crons.index, -id))) r = misns_size + *pindex;
+		if(r != -1 && is_taken[r]) r = -1;
+		if(r != -1) is_taken[r] = 1;
+		cache.fresh[p].resource = r;
+	}
+	free(is_taken);
+	return -1;
+}
+
+/** Says how many records were reused, and writes the records that were read
+ and the graph that was made from them to cache_path, for next time, unless
+ it's being kept. It's written beside it and renamed over it, so the file the
+ graph is mapped from is never written to.
+ @return	Success. */
+static int cache_save(void) {
+	struct CacheHeader head;
+	const char zero[8] = { 0 };
+	char *temp;
+	FILE *fp;
+	size_t records_size;
+	int is_ok = -1;
+
+	fprintf(stderr, "%s: %d of %d records reused.\n", cache_path, stats.reused, cache.fresh_size);
+	if(cache.is_kept) return -1;
+	if(!(temp = malloc(strlen(cache_path) + sizeof ".new"))) {
+		fprintf(stderr, "%s: %s.\n", cache_path, strerror(errno));
+		return 0;
+	}
+	strcpy(temp, cache_path);
+	strcat(temp, ".new");
+	memset(&head, 0, sizeof head);
+	memcpy(head.magic, "PngC", sizeof head.magic);
+	head.version = cache_version;
+	head.records = cache.fresh_size;
+	records_size = sizeof *cache.fresh * cache.fresh_size;
+	head.graph   = (unsigned)((sizeof head + records_size + 7) & ~7ul);
+	if(!(fp = fopen(temp, "wb"))) {
+		fprintf(stderr, "%s: %s.\n", temp, strerror(errno));
+		free(temp);
+		return 0;
+	}
+	/* the sum is of the pieces as they are written; all are whole words */
+	fwrite(&head, sizeof head, 1, fp);
+	if(records_size) fwrite(cache.fresh, records_size, 1, fp);
+	fwrite(zero, head.graph - sizeof head - records_size, 1, fp);
+	sum_add(&head.sum, cache.fresh, records_size);
+	sum_add(&head.sum, zero, head.graph - sizeof head - records_size);
+	if(!graph_write(fp, temp, &head.sum)) is_ok = 0;
+	if(is_ok && (fseek(fp, 0l, SEEK_SET) || fwrite(&head, sizeof head, 1, fp) != 1)) is_ok = 0;
+	if(ferror(fp)) is_ok = 0;
+	if(fclose(fp) == EOF) is_ok = 0;
+#ifdef _WIN32 /* rename doesn't replace */
+	if(is_ok) remove(cache_path);
+#endif
+	if(is_ok && rename(temp, cache_path)) is_ok = 0;
+	if(!is_ok) {
+		fprintf(stderr, "%s: %s.\n", temp, strerror(errno));
+		remove(temp);
+	}
+	free(temp);
+	return is_ok;
+}
+
+/** Decodes loads on threads, at the same time.
+ @return	Success. */
+static int load_all(struct List *const loads, const int threads) {
+	if(!Work(threads, ListSize(loads), (WorkAction)&load_work, ListGet(loads, 0))) {
+		fprintf(stderr, "Work: %s.\n", WorkError());
+		return 0;
+	}
+	return -1;
+}
+
+/** Reads all of the input of loads[job]; it only touches that Load, so they
+ can go at the same time.
+ @implements	WorkAction */
+static void load_work(struct Load *const loads, const int job) {
+	struct Load *const l = loads + job;
+	struct Tsv *tsv;
+	FILE *fp;
+	char *e, *copy = 0;
+
+	if(l->text) {
+		/* the Tsv cuts up the text; if the cache doesn't line up, it's read
+		 again, so that needs what was there */
+		if(cache.index) {
+			if(!(copy = malloc(l->text_size + 1))) {
+				l->error = errno;
+				return;
+			}
+			memcpy(copy, l->text, l->text_size);
+			copy[l->text_size] = '\0';
+		}
+		if(!(tsv = TsvBuffer(copy ? copy : l->text, l->text_size, l->line))) {
+			note(l, "Input: %s.\n", TsvError(0));
+			free(copy);
+			return;
+		}
+		load_decode(l, tsv);
+		Tsv_(&tsv);
+		free(copy);
+		return;
+	}
+	if(!l->path) {
+		fp = stdin;
+	} else if(!(fp = fopen(l->path, "rb"))) {
+		l->error = errno;
+		return;
+	}
+	if(!(tsv = Tsv(fp))) {
+		note(l, "Input: %s.\n", TsvError(0));
+	} else {
+		load_decode(l, tsv);
+		if((e = TsvError(tsv))) note(l, "Input: %s.\n", e);
+		Tsv_(&tsv);
+	}
+	if(l->path) fclose(fp);
+}
+
+/** Decodes all the records of tsv into l; with -c, they are hashed, and the
+ ones that are in the cache are not decoded. */
+static void load_decode(struct Load *const l, struct Tsv *const tsv) {
+	const unsigned char t_misn = T_MISN, t_cron = T_CRON, t_reused = T_REUSED,
+		t_rejected = T_REJECTED;
+	struct Cron c;
+	struct Misn m;
+	struct Hash hash;
+
+	while(TsvNext(tsv)) {
+		if(cache_path) {
+			record_hash(tsv, &hash);
+			if(!ListAdd(l->hashes, &hash)) l->error = ENOMEM;
+			if(cache.index && cache_get(&hash) != -1) {
+				if(!ListAdd(l->order, &t_reused)) l->error = ENOMEM;
+				l->reused++;
+				continue;
+			}
+		}
+		switch(decode(l, tsv, &m, &c)) {
+			case T_CRON:
+				if(!ListAdd(l->crons, &c) || !ListAdd(l->order, &t_cron)) l->error = ENOMEM;
+				break;
+			case T_MISN:
+				if(!ListAdd(l->misns, &m) || !ListAdd(l->order, &t_misn)) l->error = ENOMEM;
+				break;
+			default:
+				if(!ListAdd(l->order, &t_rejected)) l->error = ENOMEM;
+				l->rejected++;
+				break;
+		}
+	}
+}
+
+/** Decodes the current record of tsv into m or c.
+ @return	T_MISN or T_CRON, or -1 if it's neither or it can't be decoded. */
+static int decode(struct Load *const l, struct Tsv *const tsv, struct Misn *const m, struct Cron *const c) {
+	const char *const tag = TsvField(tsv, 0);
+
+	if(!strcmp(tag, "cron")) {
+		memset(c, 0, sizeof *c);
+		c->is_used = -1;
+		if(!read_record(c, cron_fields, cron_fields_size, tsv, l)) return -1;
+		if(c->id < resource_min) {
+			note(l, "cron %d<%.128s> is less than %d.\n", c->id, c->name, resource_min);
+			return -1;
+		}
+		escape(c->name);
+		return T_CRON;
+
+	} else if(!strcmp(tag, "misn")) {
+		memset(m, 0, sizeof *m);
+		m->is_used = -1;
+		if(!read_record(m, misn_fields, misn_fields_size, tsv, l)) return -1;
+		if(m->id < resource_min) {
+			note(l, "Misn %d<%.128s> is less than %d.\n", m->id, m->name, resource_min);
+			return -1;
+		}
+		escape(m->name);
+		return T_MISN;
+
+	}
+	return -1;
+}
+
+/** Puts what was read in l into the stores, replacing the ids that are
+ already there, and prints the notes, all in the order they were read, so
+ it's the same as reading them one after another.
+ @param is_store	If false, the graph came from the cache, and only the
+					notes are printed.
+ @return	Success. */
+static int load_commit(struct Load *const l, const int is_store) {
+	unsigned char *type;
+	int m = 0, c = 0, n = 0;
+
+	stats.rejected += l->rejected;
+	stats.reused   += l->reused;
+	while((type = ListIterate(l->order))) {
+		switch(*type) {
+			case T_MISN:
+				if(is_store) store_put(&misns, ListGet(l->misns, m++));
+				stats.misns_read++;
+				break;
+			case T_CRON:
+				if(is_store) store_put(&crons, ListGet(l->crons, c++));
+				stats.crons_read++;
+				break;
+			case T_NOTE: fputs(((struct Note *)ListGet(l->notes, n++))->text, stderr); break;
+		}
+	}
+	if(l->error) {
+		fprintf(stderr, "%s: %s.\n", l->path ? l->path : "Input", strerror(l->error));
+		return 0;
+	}
+	return -1;
+}
+
+/** Adds a line to the notes of l, which go on stderr when it's committed;
+ strings in the format should have a precision so it fits. */
+static void note(struct Load *const l, const char *const format, ...) {
+	const unsigned char t_note = T_NOTE;
+	struct Note n;
+	va_list args;
+	size_t len = 0;
+
+	if(l->path) {
+		sprintf(n.text, "%.200s: ", l->path);
+		len = strlen(n.text);
+	}
+	va_start(args, format);
+	vsprintf(n.text + len, format, args);
+	va_end(args);
+	/* streaming */
+	if(!l->notes) { fputs(n.text, stderr); return; }
+	if(!ListAdd(l->notes, &n) || !ListAdd(l->order, &t_note)) l->error = ENOMEM;
+}
+
+/** Decodes the current record of tsv into reso according to fields, which
+ start after the tag.
+ @return	Success; otherwise it says which field it didn't understand. */
+static int read_record(void *const reso, const struct Field *const fields, const int fields_size, struct Tsv *const tsv, struct Load *const l) {
+	const struct Field *field;
+	const char *value;
+	int i;
+
+	if(TsvSize(tsv) <= fields_size) {
+		note(l, "Line %d: %.16s has %d fields; expected %d.\n", TsvLine(tsv), TsvField(tsv, 0), TsvSize(tsv) - 1, fields_size);
+		return 0;
+	}
+	for(i = 0; i < fields_size; i++) {
+		field = fields + i;
+		value = TsvField(tsv, i + 1);
+		switch(field->format) {
+			case F_INT:
+				if(read_int((int *)((char *)reso + field->offset), value)) continue;
+				break;
+			case F_HEX:
+				if(read_hex((unsigned *)((char *)reso + field->offset), value)) continue;
+				break;
+			case F_STRING:
+				read_string((char *)reso + field->offset, field->size, value);
+				continue;
+		}
+		note(l, "Line %d: %.16s %.64s, \"%.128s,\" not understood.\n", TsvLine(tsv), TsvField(tsv, 0), field->name, value);
+		return 0;
+	}
+	return -1;
+}
+
+/** Decimal, surrounded by optional white space.
+ @return	Whether the field is a decimal number. */
+static int read_int(int *const i, const char *field) {
+	unsigned n = 0;
+	int is_negative = 0;
+	const char *digits;
+
+	while(isspace(*field)) field++;
+	if(*field == '-') { is_negative = -1; field++; }
+	else if(*field == '+') { field++; }
+	for(digits = field; *field >= '0' && *field <= '9'; field++) {
+		if(n > (UINT_MAX - 9) / 10) return 0;
+		n = n * 10 + (*field - '0');
+	}
+	if(field == digits || !is_blank(field)
+		|| n > (is_negative ? (unsigned)INT_MAX + 1 : (unsigned)INT_MAX)) return 0;
+	*i = is_negative ? (int)(0 - n) : (int)n;
+	return -1;
+}
+
+/** Hexadecimal, with optional 0x, surrounded by optional white space.
+ @return	Whether the field is a hexadecimal number. */
+static int read_hex(unsigned *const u, const char *field) {
+	unsigned n = 0;
+	int digit;
+	const char *digits;
+
+	while(isspace(*field)) field++;
+	if(field[0] == '0' && (field[1] == 'x' || field[1] == 'X')) field += 2;
+	for(digits = field; ; field++) {
+		if(*field >= '0' && *field <= '9')      digit = *field - '0';
+		else if(*field >= 'a' && *field <= 'f') digit = *field - 'a' + 10;
+		else if(*field >= 'A' && *field <= 'F') digit = *field - 'A' + 10;
+		else break;
+		if(n > UINT_MAX >> 4) return 0;
+		n = (n << 4) | digit;
+	}
+	if(field == digits || !is_blank(field)) return 0;
+	*u = n;
+	return -1;
+}
+
+/** Copies the field, truncated to size. */
+static void read_string(char *const string, const size_t size, const char *const field) {
+	size_t i;
+
+	for(i = 0; i < size - 1 && field[i]; i++) string[i] = field[i];
+	string[i] = '\0';
+}
+
+/** @return	Whether the rest of the string is white space. */
+static int is_blank(const char *s) {
+	while(isspace(*s)) s++;
+	return !*s;
 }
 
 /** GraphViz has special meaning for these symbols; hack, just change them */
@@ -640,11 +3714,149 @@ static void escape(char *const string) {
 	}
 }
 
+/** Charges the time since the last call to the stage that was running and
+ starts s; P_SIZE stops. */
+static void stage_start(const enum Stage s) {
+	double wall, cpu;
+
+	clocks(&wall, &cpu);
+	if(stage != P_SIZE) {
+		stage_wall[stage] += wall - stage_wall0;
+		stage_cpu[stage]  += cpu - stage_cpu0;
+	}
+	stage       = s;
+	stage_wall0 = wall;
+	stage_cpu0  = cpu;
+}
+
+/** Gets the wall time and the processor time of all the threads, in seconds
+ from some time in the past. */
+static void clocks(double *const wall, double *const cpu) {
+#ifndef _WIN32
+	struct timeval tv;
+	struct rusage ru;
+
+	gettimeofday(&tv, 0);
+	*wall = tv.tv_sec + tv.tv_usec * 1e-6;
+	if(getrusage(RUSAGE_SELF, &ru)) { *cpu = 0.0; return; }
+	*cpu = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec
+		+ (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1e-6;
+#else
+	*wall = *cpu = (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/** @return	The most memory that was resident, in KiB, or zero if it's not
+ known. */
+static long peak_resident(void) {
+#ifndef _WIN32
+	struct rusage ru;
+
+	if(getrusage(RUSAGE_SELF, &ru)) return 0;
+#ifdef __APPLE__
+	return ru.ru_maxrss / 1024; /* bytes */
+#else
+	return ru.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
+
+/** Prints the time in each stage on stderr, for --timing. */
+static void timing_print(void) {
+	double wall = 0.0, cpu = 0.0;
+	int s;
+
+	fprintf(stderr, "%-18s %9s %9s\n", "Timing:", "wall s", "cpu s");
+	for(s = 0; s < P_SIZE; s++) {
+		fprintf(stderr, "  %-16s %9.4f %9.4f\n", stage_name[s], stage_wall[s], stage_cpu[s]);
+		wall += stage_wall[s];
+		cpu  += stage_cpu[s];
+	}
+	fprintf(stderr, "  %-16s %9.4f %9.4f\n", "total", wall, cpu);
+	fprintf(stderr, "%d records, %.0f records/s; peak resident %ld KiB.\n", stats.misns_read + stats.crons_read, wall > 0.0 ? (stats.misns_read + stats.crons_read) / wall : 0.0, peak_resident());
+}
+
+/** Writes the times of the stages and the counts as JSON to stats_path, or
+ stderr if it's "-," for --stats; the graph is still there.
+ @return	Success. */
+static int stats_print(void) {
+	const int is_file = strcmp(stats_path, "-");
+	size_t allocations, bytes;
+	FILE *fp;
+	int s, bits_seen, bits_used = 0;
+
+	if(!is_file) {
+		fp = stderr;
+	} else if(!(fp = fopen(stats_path, "w"))) {
+		fprintf(stderr, "%s: %s.\n", stats_path, strerror(errno));
+		return 0;
+	}
+	bits_seen = graph.bits_size;
+	for(s = 0; s < graph.bits_size; s++) if(graph.bits[s].is_used) bits_used++;
+	ListCount(&allocations, &bytes);
+	fprintf(fp, "{\n  \"stages\": {");
+	for(s = 0; s < P_SIZE; s++) {
+		fprintf(fp, "%s\n    \"%s\": { \"wall\": %.6f, \"cpu\": %.6f }", s ? "," : "", stage_name[s], stage_wall[s], stage_cpu[s]);
+	}
+	fprintf(fp, "\n  },\n");
+	fprintf(fp, "  \"records\": { \"misns\": %d, \"crons\": %d, \"rejected\": %d, \"reused\": %d },\n", stats.misns_read, stats.crons_read, stats.rejected, stats.reused);
+	fprintf(fp, "  \"bits\": { \"seen\": %d, \"used\": %d, \"culled\": %d },\n", bits_seen, bits_used, stats.bits_culled);
+	fprintf(fp, "  \"crons\": { \"culled\": %d },\n", stats.crons_culled);
+	fprintf(fp, "  \"misns\": { \"culled\": %d, \"merged\": %d, \"compares\": %lu },\n", stats.misns_culled, stats.misns_merged, stats.misn_compares);
+	fprintf(fp, "  \"lists\": { \"allocations\": %lu, \"bytes\": %lu },\n", (unsigned long)allocations, (unsigned long)bytes);
+	fprintf(fp, "  \"emitted\": { \"nodes\": %ld, \"edges\": %ld },\n", stats.nodes_emitted, stats.edges_emitted);
+	fprintf(fp, "  \"peak_resident_kib\": %ld\n}\n", peak_resident());
+	if(is_file && fclose(fp)) {
+		fprintf(stderr, "%s: %s.\n", stats_path, strerror(errno));
+		return 0;
+	}
+	return -1;
+}
+
 /** Prints command-line help. */
 static void usage(void) {
-	fprintf(stderr, "Usage: %s < novadata.tsv > allmisns.gv\n\n", programme);
+	fprintf(stderr, "Usage: %s [-j threads] [-c cache] [--stream] [--reach] [--timing]\n       [--explore [--explore-depth 16] [--explore-states 100000]]\n       [--simulate years [--start 1177-01-16] [--seed 1]]\n       [--focus misn128,bit6666 [--depth 2] [--direction forward|backward|both]]\n       [--stats stats.json] [--save-graph graph | --load-graph graph]\n       [novadata.tsv ...] > allmisns.gv\n\n", programme);
 	fprintf(stderr, "The input file, eg, novadata.tsv, is misns and crons exported with EVNEW text\n");
-	fprintf(stderr, "1.0.1; the output file, eg, allmisns.gv, is a GraphViz file; see\n");
+	fprintf(stderr, "1.0.1; with no files, or -, it is read from stdin. With more than one, eg,\n");
+	fprintf(stderr, "the game and then plug-ins, ids in later files replace the same ids in earlier\n");
+	fprintf(stderr, "ones, like the game does. With -j, the files are read whole, cut into pieces\n");
+	fprintf(stderr, "at the lines, and decoded on that many threads; the output is the same.\n");
+	fprintf(stderr, "With -c, the graph is saved in the file cache with a hash of every record, and\n");
+	fprintf(stderr, "the next time, records that hash the same are not decoded; if the only ones\n");
+	fprintf(stderr, "that changed are misns and crons that kept their place and id, just they are\n");
+	fprintf(stderr, "parsed into the graph from the cache, and warned about. Otherwise, all of them\n");
+	fprintf(stderr, "are read again.\n");
+	fprintf(stderr, "--save-graph writes the parsed graph to a file that --load-graph maps instead\n");
+	fprintf(stderr, "of reading any input; it's only good with the same build.\n");
+	fprintf(stderr, "--stream prints each record as soon as it's read, so the memory doesn't grow\n");
+	fprintf(stderr, "with the input; nothing is culled or merged, and it can't be used with -j, -c,\n");
+	fprintf(stderr, "--save-graph, --load-graph, --reach, --explore, --simulate, --focus, --stats,\n");
+	fprintf(stderr, "or --timing.\n");
+	fprintf(stderr, "--reach prints the misns and crons that can never be reached by a new\n");
+	fprintf(stderr, "pilot, with all the bits clear, and the bits they wait for, instead of the\n");
+	fprintf(stderr, "GraphViz. The tests are evaluated in full, with any and, or, not and\n");
+	fprintf(stderr, "parentheses; a test that doesn't parse is warned about and taken to be true.\n");
+	fprintf(stderr, "--explore goes through the states of the bits from all clear, doing any misn\n");
+	fprintf(stderr, "that's available or cron that's enabled, on -j threads, to --explore-depth\n");
+	fprintf(stderr, "steps or --explore-states states. It prints where a misn or cron starts or\n");
+	fprintf(stderr, "aborts a misn that's not available right after, how often, and the fewest\n");
+	fprintf(stderr, "steps it took; then the misns that are started or aborted by another, but\n");
+	fprintf(stderr, "were never available. If it runs out of states, the ones that were seen\n");
+	fprintf(stderr, "depend on the threads.\n");
+	fprintf(stderr, "--simulate runs the crons for that many years of game time from --start,\n");
+	fprintf(stderr, "using their dates, random, duration, holdoffs and enable tests, and prints\n");
+	fprintf(stderr, "when each starts and ends and the bits it changes; the random draws are from\n");
+	fprintf(stderr, "--seed, so a run can be repeated. It skips the days that no cron has anything\n");
+	fprintf(stderr, "to do. The cron flags aren't read.\n");
+	fprintf(stderr, "--focus prints only the misns, crons and bits within --depth edges of the\n");
+	fprintf(stderr, "ones given, following the arrows --direction, so dot can lay it out.\n");
+	fprintf(stderr, "--timing prints the time spent in each stage, the records per second, and\n");
+	fprintf(stderr, "the peak memory on stderr. --stats writes the same times, and counts of what\n");
+	fprintf(stderr, "was read, culled, merged, allocated and printed, as JSON to a file, or stderr\n");
+	fprintf(stderr, "if it's -.\n");
+	fprintf(stderr, "The output file, eg, allmisns.gv, is a GraphViz file; see\n");
 	fprintf(stderr, "http://www.graphviz.org/. Then one could get a graph,\n\n");
 	fprintf(stderr, "dot (or fdp, etc) allmisns.gv -O -Tpdf, or use the GUI.\n\n");
 	fprintf(stderr, "Assumes all positive bits can be grouped in a minterm and all negative bits a\n");
@@ -3,7 +3,17 @@ struct Cluster {
 	struct List *clear;
 };
 
-enum Type { T_MISN, T_CRON };
+/* what is in the order of a Load; a record is reused from the -c cache */
+enum Type { T_MISN, T_CRON, T_NOTE, T_REUSED, T_REJECTED };
+
+/* resources of one type, looked up by id */
+struct Store {
+	char *name;
+	size_t width, id;	/* sizeof the resource and offsetof its id */
+	ListMetric compare;	/* compares ids */
+	struct List *list;	/* the resources; sorted by id after reading */
+	struct Map *index;	/* id -> index in list */
+};
 
 enum Where { M_AVAILABLE, M_ACCEPT, M_REFUSE, M_SUCCESS, M_ABORT, M_SHIP, C_ENABLE, C_START, C_END };
 
@@ -11,16 +21,6 @@ struct Bit {
 	int is_used;
 
 	int bit;
-	struct Cluster misn_available;
-	struct Cluster misn_accept;
-	struct Cluster misn_refuse;
-	struct Cluster misn_success;
-	struct Cluster misn_abort;
-	struct Cluster misn_ship;
-	struct Cluster cron_enable;
-	struct Cluster cron_start;
-	struct Cluster cron_end;
-
 };
 
 struct Misn {
@@ -79,11 +79,6 @@ struct Misn {
 	int can_abort;
 	unsigned flags_1;
 	unsigned flags_2;
-	
-	/* parse into numeric data */
-	struct Cluster b_available, b_accept, b_refuse, b_success, b_failure, b_abort, b_ship;
-	struct Cluster misn_accept, misn_refuse, misn_success, misn_failure, misn_abort, misn_ship;
-	
 };
 static const int misn_name_size = sizeof((struct Misn *)0)->name / sizeof(char);
 
@@ -117,29 +112,375 @@ struct Cron {
 	int government_news_4;
 	int independent_news;
 	int flags;
-	
-	/* parse into numeric data */
+};
+
+/* parse into numeric data; they are only needed until the graph is frozen,
+ so they are kept apart from the records */
+struct MisnClusters {
+	struct Cluster b_available, b_accept, b_refuse, b_success, b_failure, b_abort, b_ship;
+	struct Cluster misn_accept, misn_refuse, misn_success, misn_failure, misn_abort, misn_ship;
+};
+
+struct CronClusters {
 	struct Cluster b_enable, b_start, b_end;
-	
 };
 
-/* records the things that go together */
+/* records the things that go together; raw is in the record, the clusters
+ are in its MisnClusters or CronClusters */
 static const struct Helper {
 	char *name;
 	enum Where where;
 	size_t raw, bit_cluster, misn_cluster;
-	size_t bit_resource_cluster;
 } misn_helper[] = {
-	{ "available", M_AVAILABLE, offsetof(struct Misn, available_bits), offsetof(struct Misn, b_available), 0, offsetof(struct Bit, misn_available) },
-	{ "accept", M_ACCEPT, offsetof(struct Misn, on_accept), offsetof(struct Misn, b_accept), offsetof(struct Misn, misn_accept), offsetof(struct Bit, misn_accept) },
-	{ "refuse", M_REFUSE, offsetof(struct Misn, on_refuse), offsetof(struct Misn, b_refuse), offsetof(struct Misn, misn_refuse), offsetof(struct Bit, misn_refuse) },
-	{ "success", M_SUCCESS, offsetof(struct Misn, on_success), offsetof(struct Misn, b_success), offsetof(struct Misn, misn_success), offsetof(struct Bit, misn_success) },
-	{ "abort", M_ABORT, offsetof(struct Misn, on_abort), offsetof(struct Misn, b_abort), offsetof(struct Misn, misn_abort), offsetof(struct Bit, misn_abort) },
-	{ "on_ship_done", M_SHIP, offsetof(struct Misn, on_ship_done), offsetof(struct Misn, b_ship), offsetof(struct Misn, misn_ship), offsetof(struct Bit, misn_ship) }
+	{ "available", M_AVAILABLE, offsetof(struct Misn, available_bits), offsetof(struct MisnClusters, b_available), 0 },
+	{ "accept", M_ACCEPT, offsetof(struct Misn, on_accept), offsetof(struct MisnClusters, b_accept), offsetof(struct MisnClusters, misn_accept) },
+	{ "refuse", M_REFUSE, offsetof(struct Misn, on_refuse), offsetof(struct MisnClusters, b_refuse), offsetof(struct MisnClusters, misn_refuse) },
+	{ "success", M_SUCCESS, offsetof(struct Misn, on_success), offsetof(struct MisnClusters, b_success), offsetof(struct MisnClusters, misn_success) },
+	{ "abort", M_ABORT, offsetof(struct Misn, on_abort), offsetof(struct MisnClusters, b_abort), offsetof(struct MisnClusters, misn_abort) },
+	{ "on_ship_done", M_SHIP, offsetof(struct Misn, on_ship_done), offsetof(struct MisnClusters, b_ship), offsetof(struct MisnClusters, misn_ship) }
 }, cron_helper[] = {
-	{ "enable", C_ENABLE, offsetof(struct Cron, enable_on), offsetof(struct Cron, b_enable), 0, offsetof(struct Bit, cron_enable) },
-	{ "start", C_START, offsetof(struct Cron, on_start), offsetof(struct Cron, b_start), 0, offsetof(struct Bit, cron_start) },
-	{ "end", C_END, offsetof(struct Cron, on_end), offsetof(struct Cron, b_end), 0, offsetof(struct Bit, cron_end) }
+	{ "enable", C_ENABLE, offsetof(struct Cron, enable_on), offsetof(struct CronClusters, b_enable), 0 },
+	{ "start", C_START, offsetof(struct Cron, on_start), offsetof(struct CronClusters, b_start), 0 },
+	{ "end", C_END, offsetof(struct Cron, on_end), offsetof(struct CronClusters, b_end), 0 }
 };
 static const int misn_helper_size = sizeof misn_helper / sizeof(struct Helper);
 static const int cron_helper_size = sizeof cron_helper / sizeof(struct Helper);
+
+/* after parsing, the clusters are frozen into a graph in compressed sparse
+ rows; the resources are numbered misns first, then crons */
+enum EdgeFlags { E_SET = 1, E_MISN = 2 };
+
+struct Edge {
+	int to;					/* bits or misns index; resource if reverse */
+	unsigned char where;	/* enum Where */
+	unsigned char flags;	/* enum EdgeFlags */
+	unsigned short rank;	/* where it was in its test, for printing */
+};
+
+struct Adjacency {
+	int *start, *end;		/* the edges of vertex v are [start[v], end[v]) */
+	struct Edge *edges;
+	int edges_size;			/* allocated; there may be gaps between vertices */
+};
+
+struct Graph {
+	struct Misn *misns;
+	struct Cron *crons;
+	struct Bit *bits;		/* sorted */
+	int misns_size, crons_size, bits_size;
+	struct Adjacency forward;	/* resource -> bit, misn */
+	struct Adjacency reverse;	/* bit -> resource */
+	char *snapshot;			/* if it was loaded, everything is in here */
+	size_t snapshot_size;
+	int is_mapped;			/* the snapshot is mapped, not allocated */
+	int is_patched;			/* the edges and the bits are allocated, apart */
+};
+
+/* --save-graph writes the graph right after freeze in sections that are
+ found by their offset, so --load-graph maps the file and points into it with
+ nothing to decode. Everything is 32-bit ints, in the byte order of endian,
+ and null-terminated chars. The records are arrays of fixed width, and
+ S_LAYOUT says where each field is in them, so another program can read them;
+ a build that would lay them out differently can't map them, and says so */
+enum Section { S_LAYOUT, S_MISNS, S_CRONS, S_BITS, S_FORWARD_START,
+	S_FORWARD_END, S_FORWARD_EDGES, S_REVERSE_START, S_REVERSE_END,
+	S_REVERSE_EDGES, S_SIZE };
+
+struct GraphHeader {
+	char magic[4];			/* "PngG" */
+	unsigned version;
+	unsigned endian;		/* 0x01020304 as written */
+	unsigned misn_width, cron_width, bit_width, edge_width;
+	int misns_size, crons_size, bits_size, forward_size, reverse_size;
+	unsigned offset[S_SIZE], size[S_SIZE]; /* of the sections, bytes */
+};
+
+/* S_LAYOUT is an array of these, one for every field of every record */
+struct GraphField {
+	char name[24];			/* null-terminated */
+	unsigned section;		/* enum Section of the records it's in */
+	unsigned format;		/* enum Format; F_HEX is unsigned */
+	unsigned offset, width;	/* in the record, bytes */
+};
+
+/* --timing charges the time to the stage that is running */
+enum Stage { P_READ, P_FREEZE, P_CULL_CRONS, P_CULL_DEGREE, P_MERGE, P_EMIT,
+	P_ANALYSE, P_SIZE };
+
+/* the available and enable tests of the misns and crons, compiled so the
+ analyses can run them exactly; the parsing for the graph assumes
+ and-positives and or-negatives, which is fine for drawing, but not for this */
+struct Tests {
+	struct Expr **exprs;	/* [resources], null is true */
+	int *watch_start;		/* [bits + 1], the tests each bit is in */
+	int *watch;				/* resources */
+};
+
+/* a bit in a test, while they are being compiled */
+struct Watch {
+	int bit, resource;
+};
+
+/* --explore; a state is the bits that the tests read, and the states that
+ have been seen are kept by their Zobrist hash, the xor of a random key for
+ each bit that's set, so a transition only changes it by the bits it changes;
+ the hashes are split over shards that are locked one at a time */
+struct Key {
+	unsigned long a, b;		/* 32 bits each, so it's the same everywhere */
+};
+
+/* a state that's been seen, and the fewest transitions it took */
+struct Visit {
+	struct Key key;
+	int depth;
+};
+
+struct Shard {
+	pthread_mutex_t lock;
+	struct Visit *visits;	/* open addressing; a zero key is empty */
+	int size, capacity;
+	int zero_depth;			/* of the zero key, or -1 */
+};
+
+/* each thread's own */
+struct Explore {
+	struct BitSet *state;
+	struct BitSet *available;	/* misns that were ever available */
+	int *undo;				/* the bits a transition changed */
+	int *started;			/* the starts index and misn of each it starts or aborts */
+	char *item;				/* the next struct ExploreItem */
+	int reserved;			/* states taken from the budget and not used */
+	int is_spent;			/* the budget has nothing left to take */
+	int states;				/* that it added */
+	int *broken_depth;		/* [starts] the least depth it was not available, or -1 */
+	int *broken_count;		/* [starts] the times it was not available */
+};
+
+/* a work item is this and then the bits */
+struct ExploreItem {
+	int depth;
+	struct Key key;
+};
+
+struct Explorer {
+	struct Tests tests;
+	struct Key *zobrist;	/* [bits] */
+	int *starts;			/* [resources + 1] the E_MISN edges before each */
+	int threads;
+	pthread_mutex_t lock;	/* of the ones below it */
+	int taken;				/* from explore_states by the threads, in batches */
+	int is_full;			/* a state was not added for explore_states */
+	int errno_copy;			/* a shard could not grow */
+	struct Shard *shards;
+	struct Explore *explores;	/* [threads] */
+	size_t width;			/* of an item */
+};
+
+/* --simulate; the calendar goes from one day that a cron has something to do
+ to the next, and each cron is waiting, holding off before it starts,
+ running, or holding off after it ends */
+struct Date {
+	int year, month, day;
+};
+
+enum RunState { R_IDLE, R_PRE, R_ACTIVE, R_POST };
+
+struct Run {
+	enum RunState state;
+	long until;				/* the day that R_PRE, R_ACTIVE, or R_POST is over */
+	long wake;				/* the next day it's looked at, or LONG_MAX */
+	int heap;				/* where it is in the wakes */
+	int is_enabled;			/* the enable test, kept up to date */
+	int starts;
+};
+
+struct Simulator {
+	struct Tests tests;
+	struct BitSet *set;		/* the bits */
+	struct Run *runs;		/* [crons] */
+	int *wakes;				/* [crons] a heap, by wake and then by index */
+	struct Date date;		/* today */
+	long today, end;		/* days, @see{date_day} */
+	int current;			/* the cron that's being looked at today */
+	unsigned long seed;
+	long starts, ends, changes;
+};
+
+/* --stats; they are counted all the time, since it's cheap, but for the
+ allocations of the lists, which take a lock */
+struct Stats {
+	int misns_read, crons_read;	/* records, even ones that are replaced */
+	int rejected, reused;
+	int bits_culled, crons_culled, misns_culled, misns_merged;
+	unsigned long misn_compares;
+	long nodes_emitted, edges_emitted;
+};
+
+/* the columns of the records after the tag, in the order EVNEW exports them;
+ strings are truncated to size, counting the null */
+enum Format { F_INT, F_HEX, F_STRING };
+
+static const struct Field {
+	char *name;
+	enum Format format;
+	size_t offset, size;
+} misn_fields[] = {
+	{ "id", F_INT, offsetof(struct Misn, id), 0 },
+	{ "name", F_STRING, offsetof(struct Misn, name), 128 },
+	{ "available_stellar", F_INT, offsetof(struct Misn, available_stellar), 0 },
+	{ "available_location", F_INT, offsetof(struct Misn, available_location), 0 },
+	{ "available_record", F_INT, offsetof(struct Misn, available_record), 0 },
+	{ "available_rating", F_INT, offsetof(struct Misn, available_rating), 0 },
+	{ "available_random", F_INT, offsetof(struct Misn, available_random), 0 },
+	{ "travel_stellar", F_INT, offsetof(struct Misn, travel_stellar), 0 },
+	{ "return_stellar", F_INT, offsetof(struct Misn, return_stellar), 0 },
+	{ "cargo_type", F_INT, offsetof(struct Misn, cargo_type), 0 },
+	{ "cargo_amount", F_INT, offsetof(struct Misn, cargo_amount), 0 },
+	{ "cargo_pickup_mode", F_INT, offsetof(struct Misn, cargo_pickup_mode), 0 },
+	{ "cargo_dropoff_mode", F_INT, offsetof(struct Misn, cargo_dropoff_mode), 0 },
+	{ "scan_mask", F_HEX, offsetof(struct Misn, scan_mask), 0 },
+	{ "pay_value", F_INT, offsetof(struct Misn, pay_value), 0 },
+	{ "ship_count", F_INT, offsetof(struct Misn, ship_count), 0 },
+	{ "ship_system", F_INT, offsetof(struct Misn, ship_system), 0 },
+	{ "ship_dude", F_INT, offsetof(struct Misn, ship_dude), 0 },
+	{ "ship_goal", F_INT, offsetof(struct Misn, ship_goal), 0 },
+	{ "ship_behavior", F_INT, offsetof(struct Misn, ship_behavior), 0 },
+	{ "ship_name", F_INT, offsetof(struct Misn, ship_name), 0 },
+	{ "ship_start", F_INT, offsetof(struct Misn, ship_start), 0 },
+	{ "completion_government", F_INT, offsetof(struct Misn, completion_government), 0 },
+	{ "completion_reward", F_INT, offsetof(struct Misn, completion_reward), 0 },
+	{ "ship_subtitle", F_INT, offsetof(struct Misn, ship_subtitle), 0 },
+	{ "briefing_desc", F_INT, offsetof(struct Misn, briefing_desc), 0 },
+	{ "quick_briefing_desc", F_INT, offsetof(struct Misn, quick_briefing_desc), 0 },
+	{ "load_cargo_desc", F_INT, offsetof(struct Misn, load_cargo_desc), 0 },
+	{ "dropoff_cargo_desc", F_INT, offsetof(struct Misn, dropoff_cargo_desc), 0 },
+	{ "completion_desc", F_INT, offsetof(struct Misn, completion_desc), 0 },
+	{ "failing_desc", F_INT, offsetof(struct Misn, failing_desc), 0 },
+	{ "ship_done_desc", F_INT, offsetof(struct Misn, ship_done_desc), 0 },
+	{ "refusing_desc", F_INT, offsetof(struct Misn, refusing_desc), 0 },
+	{ "time_limit", F_INT, offsetof(struct Misn, time_limit), 0 },
+	{ "aux_ship_count", F_INT, offsetof(struct Misn, aux_ship_count), 0 },
+	{ "aux_ship_dude", F_INT, offsetof(struct Misn, aux_ship_dude), 0 },
+	{ "aux_ship_syst", F_INT, offsetof(struct Misn, aux_ship_syst), 0 },
+	{ "available_ship_type", F_INT, offsetof(struct Misn, available_ship_type), 0 },
+	{ "available_bits", F_STRING, offsetof(struct Misn, available_bits), 128 },
+	{ "on_accept", F_STRING, offsetof(struct Misn, on_accept), 128 },
+	{ "on_refuse", F_STRING, offsetof(struct Misn, on_refuse), 128 },
+	{ "on_success", F_STRING, offsetof(struct Misn, on_success), 128 },
+	{ "on_failure", F_STRING, offsetof(struct Misn, on_failure), 128 },
+	{ "on_abort", F_STRING, offsetof(struct Misn, on_abort), 128 },
+	{ "on_ship_done", F_STRING, offsetof(struct Misn, on_ship_done), 128 },
+	{ "require_bits", F_HEX, offsetof(struct Misn, require_bits), 0 },
+	{ "date_increment", F_INT, offsetof(struct Misn, date_increment), 0 },
+	{ "accept_button", F_STRING, offsetof(struct Misn, accept_button), 128 },
+	{ "refuse_button", F_STRING, offsetof(struct Misn, refuse_button), 128 },
+	{ "display_weight", F_INT, offsetof(struct Misn, display_weight), 0 },
+	{ "can_abort", F_INT, offsetof(struct Misn, can_abort), 0 },
+	{ "flags_1", F_HEX, offsetof(struct Misn, flags_1), 0 },
+	{ "flags_2", F_HEX, offsetof(struct Misn, flags_2), 0 }
+}, cron_fields[] = {
+	{ "id", F_INT, offsetof(struct Cron, id), 0 },
+	{ "name", F_STRING, offsetof(struct Cron, name), 128 },
+	{ "first_day", F_INT, offsetof(struct Cron, first_day), 0 },
+	{ "first_month", F_INT, offsetof(struct Cron, first_month), 0 },
+	{ "first_year", F_INT, offsetof(struct Cron, first_year), 0 },
+	{ "last_day", F_INT, offsetof(struct Cron, last_day), 0 },
+	{ "last_month", F_INT, offsetof(struct Cron, last_month), 0 },
+	{ "last_year", F_INT, offsetof(struct Cron, last_year), 0 },
+	{ "random", F_INT, offsetof(struct Cron, random), 0 },
+	{ "duration", F_INT, offsetof(struct Cron, duration), 0 },
+	{ "pre_holdoff", F_INT, offsetof(struct Cron, pre_holdoff), 0 },
+	{ "post_holdoff", F_INT, offsetof(struct Cron, post_holdoff), 0 },
+	{ "enable_on", F_STRING, offsetof(struct Cron, enable_on), 128 },
+	{ "on_start", F_STRING, offsetof(struct Cron, on_start), 128 },
+	{ "on_end", F_STRING, offsetof(struct Cron, on_end), 128 },
+	{ "contribute", F_HEX, offsetof(struct Cron, contribute), 0 },
+	{ "require", F_HEX, offsetof(struct Cron, require), 0 },
+	{ "government_1", F_INT, offsetof(struct Cron, government_1), 0 },
+	{ "government_news_1", F_INT, offsetof(struct Cron, government_news_1), 0 },
+	{ "government_2", F_INT, offsetof(struct Cron, government_2), 0 },
+	{ "government_news_2", F_INT, offsetof(struct Cron, government_news_2), 0 },
+	{ "government_3", F_INT, offsetof(struct Cron, government_3), 0 },
+	{ "government_news_3", F_INT, offsetof(struct Cron, government_news_3), 0 },
+	{ "government_4", F_INT, offsetof(struct Cron, government_4), 0 },
+	{ "government_news_4", F_INT, offsetof(struct Cron, government_news_4), 0 },
+	{ "independent_news", F_INT, offsetof(struct Cron, independent_news), 0 },
+	{ "flags", F_INT, offsetof(struct Cron, flags), 0 }
+};
+static const int misn_fields_size = sizeof misn_fields / sizeof(struct Field);
+static const int cron_fields_size = sizeof cron_fields / sizeof(struct Field);
+
+/* the fields that are not columns, so S_LAYOUT can say where all of them are */
+static const struct Field misn_used_field[] = {
+	{ "is_used", F_INT, offsetof(struct Misn, is_used), 0 }
+}, cron_used_field[] = {
+	{ "is_used", F_INT, offsetof(struct Cron, is_used), 0 }
+}, bit_fields[] = {
+	{ "is_used", F_INT, offsetof(struct Bit, is_used), 0 },
+	{ "bit", F_INT, offsetof(struct Bit, bit), 0 }
+}, edge_fields[] = {
+	{ "to", F_INT, offsetof(struct Edge, to), 0 },
+	{ "where", F_HEX, offsetof(struct Edge, where), 0 },
+	{ "flags", F_HEX, offsetof(struct Edge, flags), 0 },
+	{ "rank", F_HEX, offsetof(struct Edge, rank), 0 }
+};
+
+/* every input is decoded on its own into a Load, perhaps on another thread,
+ and then they are put into the stores one at a time, in the order given */
+struct Note {
+	char text[512];
+};
+
+struct Load {
+	const char *path;		/* null is stdin */
+	char *text;				/* with -j, a piece of the whole file, or null */
+	size_t text_size;
+	int line;				/* the number of lines before text */
+	int is_text_owner;		/* the first piece frees the file */
+	struct List *misns;		/* struct Misn, as read */
+	struct List *crons;		/* struct Cron, as read */
+	struct List *notes;		/* struct Note, what goes on stderr */
+	struct List *order;		/* unsigned char enum Type; all of them, as read */
+	struct List *hashes;	/* struct Hash, of every record, with -c */
+	int reused;				/* records that were in the cache */
+	int rejected;			/* records that were not a misn or a cron */
+	int error;				/* errno, or zero */
+};
+
+/* with -c, the graph is kept in a file right after freeze, with a hash of
+ every record it was made from, in the order they were read. Next time, a
+ record that hashes the same is not decoded. If they all do, the graph is used
+ as it is; if the only ones that don't are misns or crons that kept their
+ place and id, or records that were never in the graph, only they are parsed,
+ and their edges put in the graph. Otherwise, it's all read again. Writing it
+ takes longer than patching a few records, so it's only written again when
+ more than one in cache_rewrite has changed. */
+struct Hash {
+	unsigned a, b;
+};
+
+struct CacheHeader {
+	char magic[4];			/* "PngC" */
+	unsigned version;
+	int records;			/* CacheRecord after the header */
+	unsigned graph;			/* the offset of the graph, as --save-graph */
+	struct Hash sum;		/* of everything after the header */
+};
+
+struct CacheRecord {
+	struct Hash hash;
+	int resource;			/* it became, in the graph, or -1 */
+};
+
+struct Cache {
+	char *data;				/* the whole file, or null */
+	size_t size;
+	int is_mapped;
+	const struct CacheRecord *records; /* in the data */
+	int records_size;
+	struct Map *index;		/* hash.a -> the first record */
+	int *next;				/* record -> the next record with the same hash.a */
+	struct CacheRecord *fresh; /* of the records that were read, to save */
+	int fresh_size;
+	int is_kept;			/* few enough changed that it's not saved again */
+};
@@ -0,0 +1,281 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* malloc free */
+#include <stdio.h>  /* fread */
+#include <string.h>	/* memchr memmove strerror */
+#include <errno.h>	/* global errno */
+#include "List.h"
+#include "Tsv.h"
+
+/** Reads tab-separated values a record at a time. The stream is read in large
+ blocks and the fields are split in place in the block, so nothing is copied;
+ a field is valid until the next call to @see{TsvNext}. Double-quotes around a
+ field are taken off. Lines can be any length. @see{TsvBuffer} reads from
+ memory instead, so a big file can be cut up at the newlines and the pieces
+ read at the same time.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+static const size_t block_size = 1 << 20;
+
+enum Error {
+	E_NO_ERROR,
+	E_ERRNO
+};
+
+struct Tsv {
+	FILE   *fp;			/* null if the buffer belongs to the caller */
+	char   *buffer;		/* block + 1 for the null at the end */
+	size_t capacity;	/* the size of the buffer, not counting the null */
+	size_t start, end;	/* the valid data that has not been returned */
+	int    is_eof;
+	int    line;		/* the line number of the current record */
+	size_t record, record_end; /* the current record in the buffer */
+	struct List *fields;/* char *, in buffer */
+	enum Error error;
+	int    errno_copy;
+};
+
+/* global errors for allocation */
+static enum Error global_error;
+static int        global_errno_copy;
+
+/* private prototypes */
+
+static int fill(struct Tsv *const t);
+static void split(struct Tsv *const t, char *const line, char *end);
+
+/* public */
+
+/** Constructor.
+ @param fp	The stream that is read; it is not closed by the destructor.
+ @return	An object.
+ @throws	!fp; call @see{TsvError(0)} to see errors */
+struct Tsv *Tsv(FILE *const fp) {
+	struct Tsv *t;
+
+	if(!fp) return 0;
+
+	if(!(t = malloc(sizeof(struct Tsv)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		return 0;
+	}
+	t->fp         = fp;
+	t->buffer     = 0;
+	t->capacity   = block_size;
+	t->start      = 0;
+	t->end        = 0;
+	t->is_eof     = 0;
+	t->line       = 0;
+	t->record     = 0;
+	t->record_end = 0;
+	t->fields     = 0;
+	t->error      = E_NO_ERROR;
+	t->errno_copy = 0;
+
+	if(!(t->buffer = malloc(t->capacity + 1))
+		|| !(t->fields = List(sizeof(char *)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		Tsv_(&t);
+		return 0;
+	}
+
+	return t;
+}
+
+/** Constructor that reads records from memory; they are split in place, so
+ the buffer is changed.
+ @param buffer	The data, which stays the caller's; buffer[size] must be
+				writable, as well.
+ @param size	The size of the data.
+ @param line	The number of lines before the buffer; the first record is on
+				line + 1.
+ @return		An object.
+ @throws		!buffer; call @see{TsvError(0)} to see errors */
+struct Tsv *TsvBuffer(char *const buffer, const size_t size, const int line) {
+	struct Tsv *t;
+
+	if(!buffer) return 0;
+
+	if(!(t = malloc(sizeof(struct Tsv)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		return 0;
+	}
+	t->fp         = 0;
+	t->buffer     = buffer;
+	t->capacity   = size;
+	t->start      = 0;
+	t->end        = size;
+	t->is_eof     = -1;
+	t->line       = line;
+	t->record     = 0;
+	t->record_end = 0;
+	t->fields     = 0;
+	t->error      = E_NO_ERROR;
+	t->errno_copy = 0;
+
+	if(!(t->fields = List(sizeof(char *)))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		Tsv_(&t);
+		return 0;
+	}
+
+	return t;
+}
+
+/** Destructor.
+ @param t_ptr	A reference to the object that is to be deleted. */
+void Tsv_(struct Tsv **const t_ptr) {
+	struct Tsv *t;
+
+	if(!t_ptr || !(t = *t_ptr)) return;
+	List_(&t->fields);
+	if(t->fp) free(t->buffer);
+	free(t);
+	*t_ptr = 0;
+}
+
+/** Reads the next non-empty record and splits it into fields.
+ @return	The number of fields, or zero at the end of the stream or on error.
+ @throws	!t; E_ERRNO */
+int TsvNext(struct Tsv *const t) {
+	char *line, *newline;
+
+	if(!t) return 0;
+	ListClear(t->fields);
+	for( ; ; ) {
+		line = t->buffer + t->start;
+		if((newline = memchr(line, '\n', t->end - t->start))) {
+			t->start = newline + 1 - t->buffer;
+		} else if(!t->is_eof) {
+			if(!fill(t)) return 0;
+			continue;
+		} else if(t->start < t->end) {
+			/* the last line doesn't have a newline */
+			newline = t->buffer + t->end;
+			t->start = t->end;
+		} else {
+			return 0;
+		}
+		t->line++;
+		if(newline > line && newline[-1] == '\r') newline--;
+		if(newline == line) continue;
+		t->record     = line - t->buffer;
+		t->record_end = newline - t->buffer;
+		split(t, line, newline);
+		return ListSize(t->fields);
+	}
+}
+
+/** @return		The number of fields in the current record. */
+int TsvSize(const struct Tsv *const t) {
+	if(!t) return 0;
+	return ListSize(t->fields);
+}
+
+/** @return		The field at index in the current record, or null if there's
+				no such field. */
+char *TsvField(const struct Tsv *const t, const int index) {
+	char **pfield;
+
+	if(!t || !(pfield = ListGet(t->fields, index))) return 0;
+	return *pfield;
+}
+
+/** @return		The line number of the current record, starting at one. */
+int TsvLine(const struct Tsv *const t) {
+	if(!t) return 0;
+	return t->line;
+}
+
+/** @param psize	Set to the size of the current record.
+ @return		The bytes of the current record, as split; the tabs and the
+				quotes at the ends of fields are nulls. */
+const char *TsvRecord(const struct Tsv *const t, size_t *const psize) {
+	if(!t || !psize) return 0;
+	*psize = t->record_end - t->record;
+	return t->buffer + t->record;
+}
+
+/** See what's the error if something goes wrong. The error is reset by this
+ action.
+ @param t	Tsv, or null for the constructor.
+ @return	The last error string.
+ @throws	!t, E_NO_ERR */
+char *TsvError(struct Tsv *const t) {
+	char *str = 0;
+	enum Error *error_p;
+	int *errno_p;
+
+	error_p = t ? &t->error      : &global_error;
+	errno_p = t ? &t->errno_copy : &global_errno_copy;
+	switch(*error_p) {
+		case E_NO_ERROR:
+			break;
+		case E_ERRNO:
+			str = strerror(*errno_p);
+			*errno_p = 0;
+			break;
+	}
+	*error_p = 0;
+	return str;
+}
+
+/* private */
+
+/** Moves the unread data to the front and reads another block after it; the
+ buffer is grown if one line fills it.
+ @return	Success. */
+static int fill(struct Tsv *const t) {
+	char *buffer;
+	size_t read;
+
+	if(t->start) {
+		memmove(t->buffer, t->buffer + t->start, t->end - t->start);
+		t->end -= t->start;
+		t->start = 0;
+	}
+	if(t->end >= t->capacity) {
+		if(!(buffer = realloc(t->buffer, t->capacity * 2 + 1))) {
+			t->error = E_ERRNO;
+			t->errno_copy = errno;
+			return 0;
+		}
+		t->buffer    = buffer;
+		t->capacity *= 2;
+	}
+	read = fread(t->buffer + t->end, 1, t->capacity - t->end, t->fp);
+	t->end += read;
+	t->buffer[t->end] = '\0';
+	if(read) return -1;
+	if(ferror(t->fp)) {
+		t->error = E_ERRNO;
+		t->errno_copy = errno;
+		return 0;
+	}
+	t->is_eof = -1;
+	return -1;
+}
+
+/** Splits [line, end) at the tabs and nulls the fields in place. */
+static void split(struct Tsv *const t, char *const line, char *end) {
+	char *field, *tab;
+
+	for(field = line; ; field = tab + 1) {
+		if(!(tab = memchr(field, '\t', end - field))) tab = end;
+		*tab = '\0';
+		if(*field == '"' && tab - field >= 2 && tab[-1] == '"') {
+			tab[-1] = '\0';
+			field++;
+		}
+		ListAdd(t->fields, &field);
+		if(tab == end) break;
+	}
+}
@@ -0,0 +1,13 @@
+struct Tsv;
+
+struct Tsv *Tsv(FILE *const fp);
+struct Tsv *TsvBuffer(char *const buffer, const size_t size, const int line);
+void Tsv_(struct Tsv **const t_ptr);
+
+int TsvNext(struct Tsv *const t);
+int TsvSize(const struct Tsv *const t);
+char *TsvField(const struct Tsv *const t, const int index);
+int TsvLine(const struct Tsv *const t);
+const char *TsvRecord(const struct Tsv *const t, size_t *const psize);
+
+char *TsvError(struct Tsv *const t);
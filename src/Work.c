@@ -0,0 +1,364 @@
+/** Copyright 2026 the Penguin contributors, distributed under the terms of
+ the GNU General Public License, see copying.txt */
+
+#include <stdlib.h> /* malloc free */
+#include <string.h>	/* memcpy memmove strerror */
+#include <errno.h>	/* errno */
+#include <pthread.h>
+#include "Work.h"
+
+/** Runs jobs [0, jobs) on a pool of threads. The jobs are handed out in order
+ to whichever thread is free, and the caller's thread is one of them; the
+ order they finish in is not defined, so each job should write only into its
+ own place, and the caller puts the results together afterwards. If threads
+ can't be started, the ones that did start do the work.
+ <p>
+ @see{WorkSteal} is for work that makes more work, like a search: each thread
+ has a queue that it pushes to the back of and takes from the front of, so a
+ search goes about breadth first, and a thread that runs out takes from the
+ front of someone else's, so it gets the oldest, and probably biggest, items.
+
+ @author	the Penguin contributors
+ @version	1.0; 2026-10
+ @since		1.0; 2026-10 */
+
+enum Error {
+	E_NO_ERROR,
+	E_ERRNO,
+	E_PARAMETER
+};
+
+struct Pool {
+	pthread_mutex_t lock;
+	int next, jobs;			/* the next job that is not taken */
+	WorkAction action;
+	void *param;
+};
+
+struct Steal;
+
+/* one for each thread; only the owner pushes, anyone can take */
+struct WorkQueue {
+	pthread_mutex_t lock;
+	char *items;			/* [head, tail) of width */
+	int head, tail, capacity;
+	int worker, pushed;
+	struct Steal *steal;
+	enum Error error;
+	int errno_copy;
+};
+
+struct Steal {
+	pthread_mutex_t lock;	/* for the rest */
+	pthread_cond_t more;	/* there's more work, or it's done */
+	int pending;			/* items pushed and not finished */
+	int idle, is_done;
+	struct WorkQueue *queues;
+	int threads;
+	size_t width;
+	WorkTask task;
+	void *param;
+};
+
+static enum Error global_error;
+static int        global_errno_copy;
+
+/* private prototypes */
+
+static void *worker(void *const pool);
+static void *stealer(void *const queue);
+static int take(struct WorkQueue *const q, void *const item);
+static int is_queued(struct Steal *const steal);
+
+/* public */
+
+/** Calls action(param, job) for every job in [0, jobs) using up to threads
+ threads, and returns when they are all done.
+ @return	Success; the jobs were all done.
+ @throws	call @see{WorkError} to see errors */
+int Work(const int threads, const int jobs, const WorkAction action, void *const param) {
+	struct Pool pool;
+	pthread_t *thread;
+	int i, started = 0, e;
+
+	if(threads < 1 || jobs < 0 || !action) {
+		global_error = E_PARAMETER;
+		return 0;
+	}
+	if(threads == 1 || jobs <= 1) {
+		for(i = 0; i < jobs; i++) action(param, i);
+		return -1;
+	}
+	pool.next   = 0;
+	pool.jobs   = jobs;
+	pool.action = action;
+	pool.param  = param;
+	if((e = pthread_mutex_init(&pool.lock, 0))) {
+		global_error = E_ERRNO;
+		global_errno_copy = e;
+		return 0;
+	}
+	/* the caller is a worker, too */
+	if((thread = malloc(sizeof(pthread_t) * (threads - 1)))) {
+		for(i = 0; i < threads - 1 && i < jobs - 1; i++) {
+			if(pthread_create(thread + i, 0, &worker, &pool)) break;
+			started++;
+		}
+	}
+	worker(&pool);
+	for(i = 0; i < started; i++) pthread_join(thread[i], 0);
+	free(thread);
+	pthread_mutex_destroy(&pool.lock);
+
+	return -1;
+}
+
+/** Calls task(param, worker, item, q) for each of items, and for each item
+ that a task pushes with @see{WorkPush}, until there are none, using up to
+ threads threads. Items are copied, and the one a task gets is its own until
+ it returns; worker is in [0, threads), so a task can write into its own place.
+ @param width	The size of an item.
+ @return		Success; every item was done and every push worked.
+ @throws		call @see{WorkError} to see errors */
+int WorkSteal(const int threads, const size_t width, const void *const items, const int items_size, const WorkTask task, void *const param) {
+	struct Steal steal;
+	struct WorkQueue *q;
+	pthread_t *thread;
+	int i, started = 0, locks, e, is_ok = -1;
+
+	if(threads < 1 || !width || items_size < 0 || (items_size && !items) || !task) {
+		global_error = E_PARAMETER;
+		return 0;
+	}
+	if(!(steal.queues = calloc(threads, sizeof *steal.queues))) {
+		global_error = E_ERRNO;
+		global_errno_copy = errno;
+		return 0;
+	}
+	steal.pending = items_size;
+	steal.idle    = 0;
+	steal.is_done = !items_size;
+	steal.threads = threads;
+	steal.width   = width;
+	steal.task    = task;
+	steal.param   = param;
+	if((e = pthread_mutex_init(&steal.lock, 0))) {
+		free(steal.queues);
+		global_error = E_ERRNO;
+		global_errno_copy = e;
+		return 0;
+	}
+	if((e = pthread_cond_init(&steal.more, 0))) {
+		pthread_mutex_destroy(&steal.lock);
+		free(steal.queues);
+		global_error = E_ERRNO;
+		global_errno_copy = e;
+		return 0;
+	}
+	for(locks = 0; locks < threads; locks++) {
+		q = steal.queues + locks;
+		q->worker = locks;
+		q->steal  = &steal;
+		if((e = pthread_mutex_init(&q->lock, 0))) {
+			global_errno_copy = e;
+			is_ok = 0;
+			break;
+		}
+	}
+	/* the items start out spread over the queues */
+	for(i = 0; is_ok && i < items_size; i++) {
+		if(WorkPush(steal.queues + i % steal.threads, (const char *)items + width * i)) continue;
+		global_errno_copy = steal.queues[i % steal.threads].errno_copy;
+		is_ok = 0;
+	}
+	if(is_ok) {
+		for(i = 0; i < steal.threads; i++) steal.queues[i].pushed = 0;
+		/* the caller is a worker, too */
+		if(steal.threads > 1 && (thread = malloc(sizeof(pthread_t) * (steal.threads - 1)))) {
+			for(i = 1; i < steal.threads; i++) {
+				if(pthread_create(thread + i - 1, 0, &stealer, steal.queues + i)) break;
+				started++;
+			}
+		} else {
+			thread = 0;
+		}
+		stealer(steal.queues);
+		for(i = 0; i < started; i++) pthread_join(thread[i], 0);
+		free(thread);
+		for(i = 0; i < steal.threads; i++) {
+			if(!steal.queues[i].error) continue;
+			global_errno_copy = steal.queues[i].errno_copy;
+			is_ok = 0;
+		}
+	}
+	if(!is_ok) global_error = E_ERRNO;
+	for(i = 0; i < steal.threads; i++) {
+		free(steal.queues[i].items);
+		if(i < locks) pthread_mutex_destroy(&steal.queues[i].lock);
+	}
+	free(steal.queues);
+	pthread_cond_destroy(&steal.more);
+	pthread_mutex_destroy(&steal.lock);
+
+	return is_ok;
+}
+
+/** Adds item to the back of q, which is the one the task was given.
+ @return	Success; if it fails, @see{WorkSteal} fails when it's done. */
+int WorkPush(struct WorkQueue *const q, const void *const item) {
+	const size_t width = q ? q->steal->width : 0;
+	char *items;
+	int capacity;
+
+	if(!q || !item) return 0;
+	pthread_mutex_lock(&q->lock);
+	if(q->tail >= q->capacity) {
+		if(q->head > q->capacity / 2) {
+			/* the front has been taken */
+			memmove(q->items, q->items + width * q->head, width * (q->tail - q->head));
+			q->tail -= q->head;
+			q->head  = 0;
+		} else {
+			capacity = q->capacity ? q->capacity * 2 : 64;
+			if(!(items = realloc(q->items, width * capacity))) {
+				q->error = E_ERRNO;
+				q->errno_copy = errno;
+				pthread_mutex_unlock(&q->lock);
+				return 0;
+			}
+			q->items    = items;
+			q->capacity = capacity;
+		}
+	}
+	memcpy(q->items + width * q->tail++, item, width);
+	pthread_mutex_unlock(&q->lock);
+	q->pushed++;
+	return -1;
+}
+
+/** See what's the error if something goes wrong. The error is reset by this
+ action.
+ @return	The last error string.
+ @throws	E_NO_ERR */
+char *WorkError(void) {
+	char *str = 0;
+
+	switch(global_error) {
+		case E_NO_ERROR:
+			break;
+		case E_ERRNO:
+			str = strerror(global_errno_copy);
+			global_errno_copy = 0;
+			break;
+		case E_PARAMETER:
+			str = "parameter out of range";
+			break;
+	}
+	global_error = 0;
+	return str;
+}
+
+/* private */
+
+/** Takes the next job until there are none.
+ @implements	pthread_create start_routine */
+static void *worker(void *const param) {
+	struct Pool *const pool = param;
+	int job;
+
+	for( ; ; ) {
+		pthread_mutex_lock(&pool->lock);
+		job = pool->next < pool->jobs ? pool->next++ : -1;
+		pthread_mutex_unlock(&pool->lock);
+		if(job == -1) break;
+		pool->action(pool->param, job);
+	}
+	return 0;
+}
+
+/** Takes items from its own queue, or from the others, and does them until
+ none are pending. The count of pending items is only touched once per item,
+ so the lock is not in the way of tasks that do anything.
+ @implements	pthread_create start_routine */
+static void *stealer(void *const param) {
+	struct WorkQueue *const q = param;
+	struct Steal *const steal = q->steal;
+	void *item;
+
+	if(!(item = malloc(steal->width))) {
+		/* another thread can do it */
+		pthread_mutex_lock(&steal->lock);
+		q->error = E_ERRNO;
+		q->errno_copy = errno;
+		pthread_mutex_unlock(&steal->lock);
+		return 0;
+	}
+	for( ; ; ) {
+		if(!take(q, item)) {
+			pthread_mutex_lock(&steal->lock);
+			if(steal->is_done) {
+				pthread_mutex_unlock(&steal->lock);
+				break;
+			}
+			/* a push since looking is seen here; one after this is in a task
+			 that can't finish until this is waiting, and it will say */
+			if(!is_queued(steal)) {
+				steal->idle++;
+				pthread_cond_wait(&steal->more, &steal->lock);
+				steal->idle--;
+			}
+			pthread_mutex_unlock(&steal->lock);
+			continue;
+		}
+		q->pushed = 0;
+		steal->task(steal->param, q->worker, item, q);
+		pthread_mutex_lock(&steal->lock);
+		steal->pending += q->pushed - 1;
+		if(!steal->pending) {
+			steal->is_done = -1;
+			pthread_cond_broadcast(&steal->more);
+		} else if(q->pushed && steal->idle) {
+			pthread_cond_broadcast(&steal->more);
+		}
+		pthread_mutex_unlock(&steal->lock);
+	}
+	free(item);
+	return 0;
+}
+
+/** Takes from the front of q, or of another queue.
+ @return	Whether it got an item. */
+static int take(struct WorkQueue *const q, void *const item) {
+	struct Steal *const steal = q->steal;
+	const size_t width = steal->width;
+	struct WorkQueue *v;
+	int i, is_taken = 0;
+
+	for(i = 0; !is_taken && i < steal->threads; i++) {
+		v = steal->queues + (q->worker + i) % steal->threads;
+		pthread_mutex_lock(&v->lock);
+		if(v->tail > v->head) {
+			memcpy(item, v->items + width * v->head++, width);
+			if(v->tail == v->head) v->head = v->tail = 0;
+			is_taken = -1;
+		}
+		pthread_mutex_unlock(&v->lock);
+	}
+	return is_taken;
+}
+
+/** Looks in every queue; the queues are locked inside steal's lock, and never
+ the other way around.
+ @return	Whether any queue has items. */
+static int is_queued(struct Steal *const steal) {
+	struct WorkQueue *v;
+	int i, is_any = 0;
+
+	for(i = 0; !is_any && i < steal->threads; i++) {
+		v = steal->queues + i;
+		pthread_mutex_lock(&v->lock);
+		is_any = v->tail > v->head;
+		pthread_mutex_unlock(&v->lock);
+	}
+	return is_any ? -1 : 0;
+}
@@ -0,0 +1,10 @@
+struct WorkQueue;
+
+typedef void (*WorkAction)(void *const param, const int job);
+typedef void (*WorkTask)(void *const param, const int worker, void *const item, struct WorkQueue *const q);
+
+int Work(const int threads, const int jobs, const WorkAction action, void *const param);
+int WorkSteal(const int threads, const size_t width, const void *const items, const int items_size, const WorkTask task, void *const param);
+int WorkPush(struct WorkQueue *const q, const void *const item);
+
+char *WorkError(void);